@@ -13,7 +13,11 @@ class Adder : public Component {
 public:
     SetGraphicsType(Adder);
     Adder(std::string name, SimComponent* parent) : Component(name, parent) {
-        out << [=] { return op1.template value<VSRTL_VT_S>() + op2.template value<VSRTL_VT_S>(); };
+        if constexpr (isWideWidth(W)) {
+            out << [=] { return op1.wideValue() + op2.wideValue(); };
+        } else {
+            out << [=] { return op1.template value<VSRTL_VT_S>() + op2.template value<VSRTL_VT_S>(); };
+        }
     }
 
     INPUTPORT(op1, W);
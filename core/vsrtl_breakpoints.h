@@ -0,0 +1,251 @@
+#ifndef VSRTL_BREAKPOINTS_H
+#define VSRTL_BREAKPOINTS_H
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "vsrtl_defines.h"
+#include "vsrtl_port.h"
+#include "vsrtl_schedule.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The WatchCondition enum
+ * Conditions on the value of a port. Value conditions compare the (unsigned) value of the port to the operand of the
+ * term. Edge conditions hold only in the cycle in which the port changed:
+ * rising:  the port changed from 0 to a non-zero value
+ * falling: the port changed from a non-zero value to 0
+ * changed: the port changed to any other value
+ */
+enum class WatchCondition { equal, notEqual, less, greater, rising, falling, changed };
+
+/**
+ * @brief The WatchTerm struct
+ * A single term of a breakpoint predicate. For ports wider than VSRTL_VT_U, values are compared to the least
+ * significant word of the port, whereas edges consider all bits of the port.
+ */
+struct WatchTerm {
+    const PortBase* port = nullptr;
+    WatchCondition condition = WatchCondition::changed;
+    VSRTL_VT_U value = 0;
+};
+
+using BreakpointId = unsigned int;
+
+/**
+ * @brief The BreakpointEngine class
+ * A breakpoint is a conjunction of watch terms, which triggers once all of its terms hold after a cycle in which at
+ * least one of its ports changed value. Breakpoints are compiled against a propagation schedule into a flat list of
+ * watched slots, each referring to the breakpoints reading it. After each cycle, check() compares the watched slots to
+ * their values at the previous check, and only evaluates the breakpoints of slots which changed.
+ */
+class BreakpointEngine {
+public:
+    BreakpointId add(const std::vector<WatchTerm>& terms) {
+        const BreakpointId id = m_nextId++;
+        m_breakpoints[id] = terms;
+        m_compiled = false;
+        return id;
+    }
+
+    bool remove(BreakpointId id) {
+        m_compiled = false;
+        return m_breakpoints.erase(id) != 0;
+    }
+
+    void clear() {
+        m_breakpoints.clear();
+        m_compiled = false;
+    }
+
+    bool empty() const { return m_breakpoints.empty(); }
+    bool isCompiled() const { return m_compiled; }
+
+    /**
+     * @brief compile
+     * Resolves the watched ports of all breakpoints to their slots in @p schedule, and samples their current values.
+     */
+    void compile(const PropagationSchedule& schedule, const std::vector<VSRTL_VT_U>& values) {
+        m_watches.clear();
+        m_terms.clear();
+        m_checks.clear();
+        m_ids.clear();
+        m_watchedBy.clear();
+        m_watchedByOffsets.clear();
+
+        std::map<unsigned, unsigned> watchOfSlot;
+        std::vector<std::vector<unsigned>> watchedBy;
+        for (const auto& bp : m_breakpoints) {
+            const unsigned check = m_checks.size();
+            m_ids.push_back(bp.first);
+            m_checks.push_back({static_cast<unsigned>(m_terms.size()), 0});
+            for (const auto& term : bp.second) {
+                const unsigned slot = schedule.slotOf(term.port);
+                auto it = watchOfSlot.find(slot);
+                if (it == watchOfSlot.end()) {
+                    it = watchOfSlot.emplace(slot, m_watches.size()).first;
+                    m_watches.push_back({slot, term.port->getLimbCount(), 0});
+                    watchedBy.emplace_back();
+                }
+                auto& readers = watchedBy[it->second];
+                if (readers.empty() || readers.back() != check)
+                    readers.push_back(check);
+                m_terms.push_back({it->second, term.condition, term.value});
+            }
+            m_checks.back().end = m_terms.size();
+        }
+
+        unsigned nLimbs = 0;
+        m_watchedByOffsets.push_back(0);
+        for (unsigned i = 0; i < m_watches.size(); i++) {
+            m_watches[i].previous = nLimbs;
+            nLimbs += m_watches[i].limbs;
+            m_watchedBy.insert(m_watchedBy.end(), watchedBy[i].begin(), watchedBy[i].end());
+            m_watchedByOffsets.push_back(m_watchedBy.size());
+        }
+        m_previous.resize(nLimbs);
+        m_changed.assign(m_watches.size(), false);
+        m_pending.assign(m_checks.size(), false);
+        m_compiled = true;
+        sample(values);
+    }
+
+    /**
+     * @brief sample
+     * Records the current values of the watched ports without evaluating breakpoints, ie. after the state of the
+     * design was modified through other means than clocking it.
+     */
+    void sample(const std::vector<VSRTL_VT_U>& values) {
+        for (const auto& w : m_watches)
+            std::copy(values.begin() + w.slot, values.begin() + w.slot + w.limbs, m_previous.begin() + w.previous);
+    }
+
+    /**
+     * @brief check
+     * Evaluates the breakpoints reading any watched port which changed since the previous check, appending the ids of
+     * triggered breakpoints to @p hits.
+     * @returns true if any breakpoint triggered
+     */
+    bool check(const std::vector<VSRTL_VT_U>& values, std::vector<BreakpointId>& hits) {
+        m_candidates.clear();
+        m_changedWatches.clear();
+        for (unsigned i = 0; i < m_watches.size(); i++) {
+            const auto& w = m_watches[i];
+            if (std::equal(values.begin() + w.slot, values.begin() + w.slot + w.limbs, m_previous.begin() + w.previous))
+                continue;
+            m_changed[i] = true;
+            m_changedWatches.push_back(i);
+            for (unsigned j = m_watchedByOffsets[i]; j < m_watchedByOffsets[i + 1]; j++) {
+                if (!m_pending[m_watchedBy[j]]) {
+                    m_pending[m_watchedBy[j]] = true;
+                    m_candidates.push_back(m_watchedBy[j]);
+                }
+            }
+        }
+
+        bool triggered = false;
+        for (const auto& c : m_candidates) {
+            m_pending[c] = false;
+            if (evaluate(m_checks[c], values)) {
+                hits.push_back(m_ids[c]);
+                triggered = true;
+            }
+        }
+
+        for (const auto& i : m_changedWatches) {
+            const auto& w = m_watches[i];
+            std::copy(values.begin() + w.slot, values.begin() + w.slot + w.limbs, m_previous.begin() + w.previous);
+            m_changed[i] = false;
+        }
+        return triggered;
+    }
+
+private:
+    struct Watch {
+        unsigned slot;
+        unsigned limbs;
+        unsigned previous;  // Offset of the previous value in m_previous
+    };
+    struct Term {
+        unsigned watch;
+        WatchCondition condition;
+        VSRTL_VT_U value;
+    };
+    struct Check {
+        unsigned begin;
+        unsigned end;
+    };
+
+    bool evaluate(const Check& check, const std::vector<VSRTL_VT_U>& values) const {
+        for (unsigned i = check.begin; i < check.end; i++) {
+            const Term& t = m_terms[i];
+            const Watch& w = m_watches[t.watch];
+            const VSRTL_VT_U value = values[w.slot];
+            const bool changed = m_changed[t.watch];
+            bool holds = false;
+            switch (t.condition) {
+                case WatchCondition::equal:
+                    holds = value == t.value;
+                    break;
+                case WatchCondition::notEqual:
+                    holds = value != t.value;
+                    break;
+                case WatchCondition::less:
+                    holds = value < t.value;
+                    break;
+                case WatchCondition::greater:
+                    holds = value > t.value;
+                    break;
+                case WatchCondition::rising:
+                    holds = changed && isZero(w) && !isZero(w, values);
+                    break;
+                case WatchCondition::falling:
+                    holds = changed && !isZero(w) && isZero(w, values);
+                    break;
+                case WatchCondition::changed:
+                    holds = changed;
+                    break;
+            }
+            if (!holds)
+                return false;
+        }
+        return true;
+    }
+
+    // Whether all limbs of the previous value of @p w are zero
+    bool isZero(const Watch& w) const { return isZero(m_previous.data() + w.previous, w.limbs); }
+    // Whether all limbs of the current value of @p w are zero
+    static bool isZero(const Watch& w, const std::vector<VSRTL_VT_U>& values) {
+        return isZero(values.data() + w.slot, w.limbs);
+    }
+    static bool isZero(const VSRTL_VT_U* limbs, unsigned count) {
+        return std::all_of(limbs, limbs + count, [](VSRTL_VT_U limb) { return limb == 0; });
+    }
+
+    std::map<BreakpointId, std::vector<WatchTerm>> m_breakpoints;
+    BreakpointId m_nextId = 0;
+    bool m_compiled = false;
+
+    // Compiled check list
+    std::vector<Watch> m_watches;
+    std::vector<Term> m_terms;
+    std::vector<Check> m_checks;
+    std::vector<BreakpointId> m_ids;
+    // Checks reading each watch, in CSR format
+    std::vector<unsigned> m_watchedBy;
+    std::vector<unsigned> m_watchedByOffsets;
+
+    std::vector<VSRTL_VT_U> m_previous;
+    std::vector<bool> m_changed;
+    std::vector<bool> m_pending;
+    std::vector<unsigned> m_candidates;
+    std::vector<unsigned> m_changedWatches;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_BREAKPOINTS_H
@@ -20,6 +20,16 @@ template <unsigned int W>
 class Collator : public Component {
 public:
     Collator(std::string name, SimComponent* parent) : Component(name, parent) {
+        if constexpr (isWideWidth(W)) {
+            out << [=] {
+                WideValue<W> value;
+                for (unsigned i = 0; i < W; i++) {
+                    value.setBit(i, static_cast<bool>(*in[i]));
+                }
+                return value;
+            };
+            return;
+        }
         out << [=] {
             VSRTL_VT_U value = 0;
             for (unsigned i = 0; i < W; i++) {
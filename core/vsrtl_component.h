@@ -34,6 +34,17 @@ namespace core {
 #define OUTPUTPORT_ENUM(name, E_t) Port<E_t::width()>& name = this->template createOutputPort<E_t::width(), E_t>(#name)
 #define OUTPUTPORTS(name, W, N) std::vector<Port<W>*> name = this->template createOutputPorts<W>("in", N)
 
+/**
+ * @brief The BitwiseFunction struct
+ * Description of a single-bit port whose value is the bitwise AND, OR or XOR of single bits of other ports. Each
+ * operand is a port and the index of the bit which is read from it.
+ */
+struct BitwiseFunction {
+    enum class Operator { And, Or, Xor };
+    Operator op = Operator::Or;
+    std::vector<std::pair<const PortBase*, unsigned>> operands;
+};
+
 class Component : public SimComponent {
 public:
     Component(std::string displayName, SimComponent* parent) : SimComponent(displayName, parent) {}
@@ -60,6 +71,28 @@ public:
     bool isPropagated() const { return m_propagationState == PropagationState::propagated; }
     void setSensitiveTo(const PortBase* p) { m_sensitivityList.push_back(p); }
     void setSensitiveTo(const PortBase& p) { setSensitiveTo(&p); }
+    const std::vector<const PortBase*>& getSensitivityList() const { return m_sensitivityList; }
+    size_t getFootprint() const override {
+        return sizeof(Component) + getAllocatedFootprint() + m_sensitivityList.capacity() * sizeof(const PortBase*);
+    }
+
+    /**
+     * @brief setStateDependent
+     * Declares that the outputs of this component are a function of state which is not visible through its input
+     * ports or sensitivity list, such as the contents of a memory. Synchronous components are implicitly state
+     * dependent.
+     */
+    void setStateDependent() { m_stateDependent = true; }
+    bool isStateDependent() const { return m_stateDependent || isSynchronous(); }
+
+    /**
+     * @brief getBitwiseFunction
+     * Components may describe single-bit output ports as bitwise functions, allowing the propagation schedule to
+     * evaluate groups of such ports bit-packed rather than through their propagation functions. The description must
+     * be equivalent to the propagation function of @p port.
+     * @returns true if @p port was described in @p function
+     */
+    virtual bool getBitwiseFunction(const PortBase* /* port */, BitwiseFunction& /* function */) const { return false; }
 
     template <unsigned int W, typename E_t = void>
     Port<W>& createInputPort(std::string name) {
@@ -80,130 +113,6 @@ public:
         return createPorts<W>(name, m_outputPorts, n);
     }
 
-    void propagateComponent(std::vector<PortBase*>& propagationStack) {
-        // Component has already been propagated
-        if (m_propagationState == PropagationState::propagated)
-            return;
-
-        if (isSynchronous()) {
-            // Registers are implicitely clocked by calling propagate() on its output ports.
-            /** @remark register <must> be saved before propagateComponent reaches the register ! */
-            m_propagationState = PropagationState::propagated;
-            for (const auto& s : getPorts<SimPort::Direction::out, PortBase>()) {
-                s->propagate(propagationStack);
-            }
-        } else {
-            /* A circuit should initially ask its subcomponents to propagate. Some subcomponents may be able to
-             * propagate and some may not. Furthermore, This subcomponent (X) may be dependent on some of its internal
-             * subcomponents to propagate.
-             * Example:
-             * Port Y is propagated, and now asks X to propagate.
-             * X contains two subcomponents, B and A. A has all of its inputs (Y) propagated. B is reliant on 'z' to be
-             * propagated. However, 'z' is dependent on A being propagated.
-             *
-             * 1.
-             * X is trying to propagate, will initially ask its subcomponents to propagate.
-             *
-             * 1.
-             * Asking A to propagate, will make port (h) propagated.
-             * Asking B to propagate is invalid, because 'z' is unpropagated.
-             *
-             * 2.
-             * Component X will then check whether all of its input ports are propagated (z, i). 'i' is propagated, but
-             * 'z' is not, so the propagation algorithm will ask the parent component of port 'z' to propagate (C).
-             *
-             * 3.
-             * C has one input which attaches to port 'h' of A - which is now propagated. So C may propagate, in turn
-             * making 'z' propagated.
-             *
-             * 4.
-             * All inputs have now been propagated to X. It will then again ask its subcomponents to try to
-             * propagate.
-             *
-             * 5.
-             *
-             *  y
-             *  +                 X
-             *  |          +--------------+
-             *  |          |   +------+   |
-             *  |          |   |      |   |
-             *  |          |   |  B   |   |
-             *  |      z   |   |      |   |        +------+
-             *  |    +---->---->      |   |        |      |
-             *  |    |     |   +------+   |        |      |
-             *  |    |     |              |    +--->  C   +----+
-             *  |    |     |   +------+   |    |   |      |    |
-             *  |    |  i  |   |      | h |    |   +------+    |
-             *  +--------->---->  A   +--------+               |
-             *       |     |   |      |   |                    |
-             *       |     |   |      |   |                    |
-             *       |     |   +------+   |                    |
-             *       |     |              |                    |
-             *       |     +--------------+                    |
-             *       |                                         |
-             *       +-----------------------------------------+
-             *
-             */
-
-            for (const auto& sc : getSubComponents<Component>())
-                sc->propagateComponent(propagationStack);
-
-            // All sequential logic must have their inputs propagated before they themselves can propagate. If this is
-            // not the case, the function will return. Iff the circuit is correctly connected, this component will at a
-            // later point be visited, given that the input port which is currently not yet propagated, will become
-            // propagated at some point, signalling its connected components to propagate.
-            for (const auto& input : getPorts<SimPort::Direction::in, PortBase>()) {
-                if (!input->isPropagated())
-                    return;
-            }
-            // Furthermore, we check whether any additional signals added to the sensitivity list are propagated.
-            for (const auto& sens : m_sensitivityList) {
-                if (!sens->isPropagated())
-                    return;
-            }
-
-            for (const auto& sc : getSubComponents<Component>())
-                sc->propagateComponent(propagationStack);
-
-            // At this point, all input ports are assured to be propagated. In this case, it is safe to propagate
-            // the outputs of the component.
-            for (const auto& s : getPorts<SimPort::Direction::out, PortBase>()) {
-                s->propagate(propagationStack);
-            }
-            m_propagationState = PropagationState::propagated;
-
-            // if any internal values have changed...
-            // @todo: implement granular change signal emission
-            if (getDesign()->signalsEnabled()) {
-                changed.Emit();
-            }
-        }
-
-        // Signal all connected components of the current component to propagate
-        for (const auto& out : getPorts<SimPort::Direction::out, PortBase>()) {
-            for (const auto& in : out->getOutputPorts()) {
-                // With the input port of the connected component propagated, the parent component may be propagated.
-                // This will succeed if all input components to the parent component has been propagated.
-                in->getParent<Component>()->propagateComponent(propagationStack);
-
-                // To facilitate output -> output connections, we need to trigger propagation in the output's parent
-                // aswell
-                /**
-                 * IN   IN   OUT  OUT
-                 *   _____________
-                 *  |    _____   |
-                 *  |   |    |   |
-                 *  |   |   ->--->
-                 *  |   |____|   |
-                 *  |____________|
-                 *
-                 */
-                for (const auto& inout : in->getOutputPorts())
-                    inout->getParent<Component>()->propagateComponent(propagationStack);
-            }
-        }
-    }
-
     void initialize() {
         if (m_inputPorts.size() == 0 && !hasSubcomponents() && m_sensitivityList.empty()) {
             // Component has no input ports - ie. component is a constant. propagate all output ports and set component
@@ -214,6 +123,37 @@ public:
         }
     }
 
+    /**
+     * @brief isFoldable
+     * A combinational leaf component is foldable if all of its inputs (and its sensitivity list) have constant values;
+     * its outputs will then never change.
+     */
+    bool isFoldable() const {
+        if (m_propagationState != PropagationState::unpropagated || hasSubcomponents() || isStateDependent())
+            return false;
+        if (m_inputPorts.empty() && m_sensitivityList.empty())
+            return false;
+        for (const auto& i : getPorts<SimPort::Direction::in, PortBase>()) {
+            if (!i->hasConstantValue())
+                return false;
+        }
+        for (const auto& sens : m_sensitivityList) {
+            if (!sens->hasConstantValue())
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief fold
+     * Evaluates the outputs of a foldable component once, excluding them from the propagation stack.
+     */
+    void fold() {
+        for (const auto& p : getPorts<SimPort::Direction::out, PortBase>())
+            p->propagateFolded();
+        m_propagationState = PropagationState::constant;
+    }
+
     virtual void verifyComponent() const {
         for (const auto& ip : getPorts<SimPort::Direction::in, PortBase>()) {
             if (!ip->isConnected()) {
@@ -245,6 +185,7 @@ protected:
     std::vector<Port<W>*> createPorts(std::string name, std::set<std::unique_ptr<SimPort>, PortBaseCompT>& container,
                                       unsigned int n) {
         std::vector<Port<W>*> ports;
+        ports.reserve(n);
         Port<W>* port;
         for (unsigned int i = 0; i < n; i++) {
             std::string i_name = name + "_" + std::to_string(i);
@@ -265,6 +206,7 @@ protected:
 
     std::vector<const PortBase*> m_sensitivityList;
     PropagationState m_propagationState = PropagationState::unpropagated;
+    bool m_stateDependent = false;
 };
 
 }  // namespace core
@@ -19,11 +19,26 @@ template <unsigned int W>
 class Decollator : public Component {
 public:
     Decollator(std::string name, SimComponent* parent) : Component(name, parent) {
-        for (int i = 0; i < W; i++) {
-            *out[i] << [=] { return (static_cast<VSRTL_VT_U>(in) >> i) & 0b1; };
+        for (unsigned i = 0; i < W; i++) {
+            if constexpr (isWideWidth(W)) {
+                *out[i] << [=] { return static_cast<VSRTL_VT_U>(in.wideValue().bit(i)); };
+            } else {
+                *out[i] << [=] { return (static_cast<VSRTL_VT_U>(in) >> i) & 0b1; };
+            }
         }
     }
 
+    bool getBitwiseFunction(const PortBase* port, BitwiseFunction& function) const override {
+        for (unsigned i = 0; i < W; i++) {
+            if (port == out[i]) {
+                function.op = BitwiseFunction::Operator::Or;
+                function.operands.push_back({&in, i});
+                return true;
+            }
+        }
+        return false;
+    }
+
     OUTPUTPORTS(out, 1, W);
     INPUTPORT(in, W);
 };
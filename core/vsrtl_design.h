@@ -1,10 +1,16 @@
 #ifndef VSRTL_DESIGN_H
 #define VSRTL_DESIGN_H
 
+#include "vsrtl_breakpoints.h"
 #include "vsrtl_component.h"
 #include "vsrtl_defines.h"
+#include "vsrtl_loopdetection.h"
 #include "vsrtl_memory.h"
+#include "vsrtl_portgraph.h"
 #include "vsrtl_register.h"
+#include "vsrtl_schedule.h"
+#include "vsrtl_state.h"
+#include "vsrtl_threadpool.h"
 
 #include <memory>
 #include <set>
@@ -18,6 +24,24 @@ namespace core {
 // components may be linked to the same sparse array to provide separate access ports to a shared address space.
 #define ADDRESSSPACE(name) SparseArray* name = this->createMemory()
 
+/**
+ * @brief The ChangeNotification enum
+ * perPort: The changed signal of each port is emitted as soon as its value changes during propagation.
+ * batched: Changed ports are recorded during propagation, and published once per operation on the design (clock,
+ *          reverse, reset, ...) through Design::changesPublished.
+ */
+enum class ChangeNotification { perPort, batched };
+
+/**
+ * @brief The ChangeSet struct
+ * The ports whose values changed during an operation on the design, and the components owning them. Each port and
+ * component is listed once.
+ */
+struct ChangeSet {
+    std::vector<PortBase*> ports;
+    std::vector<Component*> components;
+};
+
 /**
  * @brief The Design class
  * superclass for all Design descriptions
@@ -28,7 +52,8 @@ public:
 
     /**
      * @brief clock
-     * Simulates clocking the circuit. Registers are clocked and the propagation algorithm is run
+     * Simulates clocking the circuit. Registers are clocked and the propagation algorithm is run. In batch mode, all
+     * lanes are clocked.
      * @pre A call to propagate() must be done, to set the initial state of the circuit
      */
     void clock() override {
@@ -36,76 +61,532 @@ public:
             throw std::runtime_error("Design was not verified and initialized before clocking.");
         }
 
-        // Save register values (to correctly clock register -> register connections)
-        for (const auto& reg : m_clockedComponents) {
-            reg->save();
-        }
-
-        // Increment reverse-stack if possible
-        if (m_reverseStackCount < ClockedComponent::reverseStackSize()) {
-            m_reverseStackCount++;
-        }
-
-        propagateDesign();
+        recordHistory(m_reverseHistory);
+        forEachLane([this] { clockLane(); });
         SimDesign::clock();
+        checkBreakpoints();
+        publishChanges();
     }
 
+    /**
+     * @brief reverse
+     * Restores the state of the previous cycle. If the state journal holds the deltas of the current cycle, these are
+     * reverted. Otherwise, the nearest checkpoint preceding the previous cycle is restored, and the cycles following
+     * the checkpoint are re-simulated, journaling them for subsequent reversals.
+     */
     void reverse() override {
-        if (canReverse()) {
-            if (!m_isVerifiedAndInitialized) {
-                throw std::runtime_error("Design was not verified and initialized before reversing.");
-            }
-            // Clock registers
-            for (const auto& reg : m_clockedComponents) {
-                reg->reverse();
-            }
-            m_reverseStackCount--;
+        if (!canReverse())
+            return;
+        if (!m_isVerifiedAndInitialized) {
+            throw std::runtime_error("Design was not verified and initialized before reversing.");
+        }
+
+        const long long target = m_cycleCount - 1;
+        // Checkpoints beyond the target cycle will not be reached again
+        m_checkpoints.erase(m_checkpoints.upper_bound(target), m_checkpoints.end());
+        m_forceCheckpoint = false;
+
+        if (m_journal.covers(m_cycleCount)) {
+            m_journal.revertCycle([this](unsigned component, StateReader& delta) {
+                m_journaledComponents[component]->revert(delta);
+            });
             propagateDesign();
+        } else {
+            std::vector<VSRTL_VT_U> previousValues;
+            if (signalsEnabled())
+                previousValues = m_schedule.getValues();
+
+            const auto& checkpoint = *m_checkpoints.rbegin();
+            DesignState state = checkpoint.second;
+            loadLane(state);
+
+            const bool emitSignals = signalsEnabled();
+            setEnableSignals(false);
+            m_journal.clear();
+            m_journal.setRecording(m_journaling);
+            for (long long cycle = checkpoint.first; cycle < target; cycle++) {
+                if (m_journaling)
+                    m_journal.beginCycle(cycle + 1);
+                clockLane();
+            }
+            setEnableSignals(emitSignals);
+
+            if (emitSignals)
+                m_schedule.emitChangedSince(previousValues);
         }
         SimDesign::reverse();
+        sampleBreakpoints();
+        publishChanges();
     }
 
-    void propagate() override { propagateDesign(); }
+    void propagate() override {
+        forEachLane([this] { propagateDesign(); });
+        sampleBreakpoints();
+        publishChanges();
+    }
 
     /**
      * @brief reset
      * Resets the circuit, setting all registers to 0 and propagates the circuit. Constants might have an affect on the
-     * circuit in terms of not all component values being 0.
+     * circuit in terms of not all component values being 0. In batch mode, all lanes are reset.
      */
     void reset() override {
-        // Reset all memories, clearing the sparse arrays and rewriting any initialization data
-        for (const auto& memory : m_memories) {
-            memory->reset();
+        forEachLane([this] { resetLane(); });
+        clearHistory();
+        SimDesign::reset();
+        sampleBreakpoints();
+        publishChanges();
+    }
+
+    /**
+     * @brief runCycles
+     * Clocks all lanes of the design up to @p cycles times in a tight loop, with signals disabled. Unless
+     * @p reverseHistory is set, no reverse history is recorded during the run, and the run can not be reversed. The run
+     * stops once a breakpoint triggers; the triggered breakpoints are available through getBreakpointHits().
+     */
+    RunResult runCycles(long long cycles, const std::function<bool()>& stop = {},
+                        bool reverseHistory = false) override {
+        if (!m_isVerifiedAndInitialized) {
+            throw std::runtime_error("Design was not verified and initialized before running.");
         }
 
-        // reset all registers
-        // propagate everything combinational
-        for (const auto& reg : m_clockedComponents)
-            reg->reset();
-        propagateDesign();
-        m_reverseStackCount = 0;
-        SimDesign::reset();
+        RunResult result;
+        const bool emitSignals = signalsEnabled();
+        setEnableSignals(false);
+        while (result.cycles < cycles) {
+            recordHistory(m_reverseHistory && reverseHistory);
+            forEachLane([this] { clockLane(); });
+            m_cycleCount++;
+            result.cycles++;
+            if (checkBreakpoints()) {
+                result.reason = RunResult::StopReason::breakpoint;
+                break;
+            }
+            if (stop && stop()) {
+                result.reason = RunResult::StopReason::stopCondition;
+                break;
+            }
+        }
+        setEnableSignals(emitSignals);
+        return result;
     }
 
-    inline bool canReverse() const override { return m_reverseStackCount != 0; }
+    /**
+     * @brief addBreakpoint
+     * Adds a breakpoint triggering after a clock cycle in which all @p terms hold, and in which the value of at least
+     * one of the watched ports changed. Watched ports are observed (see observe()).
+     */
+    BreakpointId addBreakpoint(const std::vector<WatchTerm>& terms) {
+        if (terms.empty()) {
+            throw std::runtime_error("A breakpoint must have at least one term");
+        }
+        for (const auto& t : terms) {
+            if (!t.port || const_cast<PortBase*>(t.port)->getDesign() != this) {
+                throw std::runtime_error("Breakpoint watches a port which is not part of the design");
+            }
+        }
+        const BreakpointId id = m_breakpoints.add(terms);
+        for (const auto& t : terms)
+            observe(t.port);
+        sampleBreakpoints();
+        return id;
+    }
+    BreakpointId addBreakpoint(const PortBase& port, WatchCondition condition, VSRTL_VT_U value = 0) {
+        return addBreakpoint({{&port, condition, value}});
+    }
 
-    void createPropagationStack() {
-        // The circuit is traversed to find the sequence of which ports may be propagated, such that all input
-        // dependencies for each component are met when a port is propagated. With this, propagateDesign() may
-        // sequentially ierate through the propagation stack to propagate the value of each port
-        for (const auto& reg : m_clockedComponents)
-            reg->propagateComponent(m_propagationStack);
+    void removeBreakpoint(BreakpointId id) {
+        m_breakpoints.remove(id);
+        sampleBreakpoints();
+    }
+    void clearBreakpoints() {
+        m_breakpoints.clear();
+        sampleBreakpoints();
+    }
+
+    /**
+     * @brief getBreakpointHits
+     * @returns the breakpoints which triggered in the last clock cycle. Cleared by any other modification of the
+     * state of the design.
+     */
+    const std::vector<BreakpointId>& getBreakpointHits() const { return m_breakpointHits; }
+
+    /**
+     * @brief setReverseHistory
+     * Enables or disables recording reverse history when clocking the design. Enabled by default. Clocking the design
+     * without reverse history discards the history of all preceding cycles.
+     */
+    void setReverseHistory(bool enabled) {
+        m_reverseHistory = enabled;
+        if (!enabled)
+            clearHistory();
+    }
+    bool reverseHistory() const { return m_reverseHistory; }
+
+    /**
+     * @brief setCheckpointInterval
+     * Reverse history is recorded as a checkpoint of the full design state every @p cycles cycles. Reversing a cycle
+     * re-simulates at most @p cycles cycles from the nearest checkpoint. Once more than @p maxCheckpoints checkpoints
+     * are recorded, every other checkpoint is discarded and the interval is doubled, bounding the memory used for
+     * reverse history while retaining the ability to reverse to the start of the history.
+     */
+    void setCheckpointInterval(unsigned cycles, unsigned maxCheckpoints = 256) {
+        if (cycles == 0 || maxCheckpoints < 2) {
+            throw std::runtime_error("Invalid checkpoint interval");
+        }
+        m_checkpointInterval = cycles;
+        m_maxCheckpoints = maxCheckpoints;
+        clearHistory();
+    }
+
+    /**
+     * @brief setChangeNotification
+     * Selects whether port changes are notified per port, or batched per operation on the design. With batched
+     * notification, the changed signals of ports are not emitted; observers must connect to changesPublished.
+     */
+    void setChangeNotification(ChangeNotification notification) {
+        publishChanges();
+        m_schedule.setBatchedNotification(notification == ChangeNotification::batched);
+    }
+    ChangeNotification getChangeNotification() const {
+        return m_schedule.batchedNotification() ? ChangeNotification::batched : ChangeNotification::perPort;
+    }
+
+    /**
+     * @brief changesPublished
+     * Emitted with the set of changed ports at the end of each operation on the design which changed any port,
+     * when using ChangeNotification::batched.
+     */
+    Gallant::Signal1<const ChangeSet&> changesPublished;
+
+    /**
+     * @brief setJournalCapacity
+     * Sets the maximum number of words used for journaling the deltas of the clocked state of the design. Cycles
+     * beyond the journal are reversed through checkpoints.
+     */
+    void setJournalCapacity(size_t words) {
+        m_journalCapacity = words;
+        m_journal.trim(words);
+    }
+
+    /**
+     * @brief canReverse
+     * Reverse history is only maintained for a single lane; batch simulation cannot be reversed.
+     */
+    inline bool canReverse() const override {
+        return !m_checkpoints.empty() && m_checkpoints.begin()->first < m_cycleCount && m_lanes.size() <= 1;
+    }
+
+    /**
+     * @brief setLaneCount
+     * Enables batch simulation of @p lanes independent instances of the design. All lanes share the elaborated
+     * design and its propagation schedule, whereas each lane has its own port values, clocked state and memory
+     * contents. clock(), propagate() and reset() operate on all lanes in lockstep.
+     * The state of each new lane is a copy of the state of the active lane. Reducing the lane count discards the
+     * highest lanes; lane 0 becomes the active lane if the active lane is discarded.
+     */
+    void setLaneCount(unsigned lanes) {
+        if (!m_isVerifiedAndInitialized) {
+            throw std::runtime_error("Design must be verified and initialized before setting the lane count.");
+        }
+        if (lanes == 0) {
+            throw std::runtime_error("Lane count must be at least 1");
+        }
+        if (m_lanes.empty()) {
+            m_lanes.resize(1);
+        }
+        if (lanes <= m_activeLane) {
+            setActiveLane(0);
+        }
+        if (lanes > m_lanes.size()) {
+            DesignState state;
+            saveLane(state, true);
+            m_lanes.resize(lanes, state);
+        } else {
+            m_lanes.resize(lanes);
+        }
+        if (lanes > 1) {
+            // Reverse history cannot be attributed to individual lanes
+            clearHistory();
+        }
+    }
+    unsigned getLaneCount() const { return m_lanes.empty() ? 1 : m_lanes.size(); }
+
+    /**
+     * @brief setActiveLane
+     * Loads the state of @p lane into the design. Port values, registers and memories of the design always reflect
+     * the active lane; ie. values may be inspected, programs may be loaded (through the memories' initialization
+     * memories) and synchronous values may be forced on a per-lane basis by activating the lane beforehand.
+     */
+    void setActiveLane(unsigned lane) {
+        if (lane >= getLaneCount()) {
+            throw std::runtime_error("Lane " + std::to_string(lane) + " does not exist");
+        }
+        if (lane == m_activeLane)
+            return;
+        activateLane(lane);
+        if (signalsEnabled()) {
+            m_schedule.emitAllChanged();
+        }
+        sampleBreakpoints();
+        publishChanges();
+    }
+    unsigned getActiveLane() const { return m_activeLane; }
+
+    /**
+     * @brief laneValue
+     * @returns the value of @p port in @p lane, without activating the lane.
+     */
+    VSRTL_VT_U laneValue(unsigned lane, const PortBase* port) const {
+        if (lane >= getLaneCount()) {
+            throw std::runtime_error("Lane " + std::to_string(lane) + " does not exist");
+        }
+        if (port->isPruned()) {
+            const_cast<Design*>(this)->observe(port);
+        }
+        if (lane == m_activeLane) {
+            return port->uValue();
+        }
+        return m_lanes[lane].portValues.at(m_schedule.slotOf(port));
+    }
+
+    /**
+     * @brief createPropagationStack
+     * Orders the ports of the design such that each port is preceded by all ports which it depends on, through a
+     * topological sort (Kahn's algorithm) of @p graph. Constant and folded ports are already propagated and excluded.
+     * Ports become ready once all of their unpropagated predecessors are ordered, and are ordered in the sequence in
+     * which they become ready, starting from those without unpropagated predecessors (ie. the outputs of clocked
+     * components). The sort is linear in the number of ports and connections, and uses no recursion.
+     * With this, propagateDesign() may sequentially iterate through the propagation stack to propagate the value of
+     * each port.
+     */
+    void createPropagationStack(const PortGraph& graph) {
+        const unsigned n = graph.size();
+        std::vector<unsigned> pending(n, 0);
+        for (unsigned i = 0; i < n; i++) {
+            if (graph.port(i)->isPropagated())
+                continue;
+            for (auto it = graph.successorsBegin(i); it != graph.successorsEnd(i); ++it)
+                pending[*it]++;
+        }
+
+        std::vector<unsigned> worklist;
+        for (unsigned i = 0; i < n; i++) {
+            if (!graph.port(i)->isPropagated() && pending[i] == 0)
+                worklist.push_back(i);
+        }
+        m_propagationStack.clear();
+        m_propagationStack.reserve(n);
+        for (unsigned head = 0; head < worklist.size(); head++) {
+            const unsigned i = worklist[head];
+            m_propagationStack.push_back(graph.port(i));
+            for (auto it = graph.successorsBegin(i); it != graph.successorsEnd(i); ++it) {
+                if (--pending[*it] == 0 && !graph.port(*it)->isPropagated())
+                    worklist.push_back(*it);
+            }
+        }
+    }
+
+    /**
+     * @brief compilePropagationSchedule
+     * Lowers the propagation stack into a flat, index-based schedule operating on a contiguous port value array.
+     */
+    void compilePropagationSchedule() {
+        std::vector<PortBase*> ports;
+        for (const auto& c : m_componentGraph) {
+            if (auto* comp = c.first->cast<Component>()) {
+                for (const auto& p : comp->getAllPorts<PortBase>())
+                    ports.push_back(p);
+            }
+        }
+        m_schedule.compile(m_propagationStack, ports);
+    }
+
+    /**
+     * @brief createRegisterBank
+     * Binds the state of all registers which support it to the register bank of the design. All other clocked
+     * components are clocked through save().
+     */
+    void createRegisterBank() {
+        for (const auto& c : m_clockedComponents) {
+            auto* reg = dynamic_cast<RegisterBase*>(c);
+            if (!reg || !reg->bindToBank(m_registerBank))
+                m_unbankedComponents.push_back(c);
+        }
+    }
+
+    void propagateDesign() { propagateDesign(m_propagationMode); }
+
+    void propagateDesign(PropagationMode mode) {
+        if (!m_schedule.isCompiled()) {
+            for (const auto& p : m_propagationStack)
+                p->setPortValue();
+        } else if (mode == PropagationMode::eventDriven) {
+            m_schedule.propagateChanges(signalsEnabled());
+        } else if (mode == PropagationMode::parallel && m_schedule.getOperations().size() >= m_parallelThreshold) {
+            if (!m_threadPool) {
+                m_threadPool = std::make_unique<ThreadPool>(m_parallelThreads);
+            }
+            m_schedule.propagateParallel(*m_threadPool, m_parallelGrainSize, signalsEnabled());
+        } else {
+            m_schedule.propagate(signalsEnabled());
+        }
+    }
+
+    /**
+     * @brief setPropagationMode
+     * Selects whether the design is fully propagated after each clock cycle, or whether only the fan-out of changed
+     * state elements is re-evaluated. Event-driven propagation is beneficial for designs with low per-cycle activity.
+     */
+    void setPropagationMode(PropagationMode mode) { m_propagationMode = mode; }
+    PropagationMode getPropagationMode() const { return m_propagationMode; }
+
+    /**
+     * @brief setParallelPropagation
+     * Configures PropagationMode::parallel. @p threads threads (including the thread propagating the design) are used
+     * for propagation. Designs with fewer than @p threshold operations in their propagation schedule, as well as
+     * levels with fewer than two times @p grainSize operations, are propagated on the calling thread, avoiding the
+     * synchronization overhead for small designs.
+     */
+    void setParallelPropagation(unsigned threads, unsigned threshold = 4096, unsigned grainSize = 64) {
+        m_parallelThreads = threads;
+        m_parallelThreshold = threshold;
+        m_parallelGrainSize = std::max(grainSize, 1u);
+        m_threadPool.reset();
     }
 
-    void propagateDesign() {
-        for (const auto& p : m_propagationStack)
-            p->setPortValue();
+    /**
+     * @brief setBitPackedEvaluation
+     * Enables or disables bit-packed evaluation of single-bit logic during full propagation. Enabled by default.
+     */
+    void setBitPackedEvaluation(bool enabled) { m_schedule.setBitPacking(enabled); }
+
+    /**
+     * @brief setHeadless
+     * In headless mode, ports which affect neither the state of the design (the inputs of registers and memories) nor
+     * any observed port are pruned from propagation. Ports are observed through observe(); reading a pruned port
+     * through SimPort::uValue() or SimPort::sValue() observes it implicitly. Watchers of a port's changed signal must
+     * observe the port explicitly.
+     */
+    void setHeadless(bool headless) {
+        m_headless = headless;
+        m_schedule.setPruning(m_headless, m_observedPorts);
+    }
+    bool isHeadless() const { return m_headless; }
+
+    void observe(const SimPort* port) override {
+        auto* p = dynamic_cast<const PortBase*>(port);
+        if (!p || !m_observedPorts.insert(p).second)
+            return;
+        if (m_headless) {
+            const bool wasPruned = p->isPruned();
+            m_schedule.setPruning(m_headless, m_observedPorts);
+            if (wasPruned) {
+                // The values of newly unpruned ports are stale
+                forEachLane([this] { propagateDesign(PropagationMode::full); });
+                sampleBreakpoints();
+                publishChanges();
+            }
+        }
     }
 
+    const PropagationSchedule& getPropagationSchedule() const { return m_schedule; }
+
+    /**
+     * @brief getFoldedComponents
+     * @returns the components which were found to solely depend on constants during verifyAndInitialize(), and which
+     * are thus not propagated.
+     */
+    const std::vector<Component*>& getFoldedComponents() const { return m_foldedComponents; }
+
     void setSynchronousValue(SimSynchronous* c, VSRTL_VT_U addr, VSRTL_VT_U value) override {
         c->forceValue(addr, value);
         // Given the new output value of the register, the circuit must be repropagated
         propagateDesign();
+        // The state of the current cycle was modified; it must be checkpointed before clocking, for the following
+        // cycles to be replayed from it
+        m_checkpoints.erase(m_cycleCount);
+        m_forceCheckpoint = true;
+        // Journaled deltas do not account for the forced value
+        m_journal.clear();
+        sampleBreakpoints();
+        publishChanges();
+    }
+
+    /**
+     * @brief saveState
+     * Saves the state of the active lane.
+     */
+    void saveState(std::ostream& os) const override {
+        if (!m_isVerifiedAndInitialized) {
+            throw std::runtime_error("Design was not verified and initialized before saving its state.");
+        }
+        std::vector<VSRTL_VT_U> clockedState;
+        for (const auto& c : m_clockedComponents)
+            c->saveState(clockedState);
+        std::vector<const SparseArray*> memories;
+        for (const auto& mem : m_memories)
+            memories.push_back(mem.get());
+        BinaryState::write(os, getName(), m_cycleCount, clockedState, memories);
+    }
+
+    /**
+     * @brief restoreState
+     * Restores a state into the active lane, followed by a single propagation of the design. Reverse history is
+     * discarded.
+     */
+    void restoreState(std::istream& is) override {
+        if (!m_isVerifiedAndInitialized) {
+            throw std::runtime_error("Design was not verified and initialized before restoring its state.");
+        }
+        DesignState state;
+        for (const auto& c : m_clockedComponents)
+            c->saveState(state.clockedState);
+        state.memories.resize(m_memories.size());
+        long long cycle;
+        // The state is fully read and validated before modifying the design
+        BinaryState::read(is, getName(), cycle, state);
+        loadState(state, cycle);
+    }
+
+    /**
+     * @brief forkInto
+     * Copies the simulation state of the active lane into @p target, an elaborated instance of the same design,
+     * without serializing it. This design is not modified, and may be forked into multiple targets, which may
+     * subsequently be simulated on separate threads. Reverse history of @p target is discarded.
+     */
+    void forkInto(Design& target) const {
+        if (!m_isVerifiedAndInitialized || !target.m_isVerifiedAndInitialized) {
+            throw std::runtime_error("Designs must be verified and initialized before forking.");
+        }
+        if (&target == this || target.getName() != getName()) {
+            throw std::runtime_error("Designs can only be forked into other instances of the same design");
+        }
+        DesignState state;
+        for (const auto& c : m_clockedComponents)
+            c->saveState(state.clockedState);
+        state.memories.resize(m_memories.size());
+        for (unsigned i = 0; i < m_memories.size(); i++)
+            state.memories[i].data = m_memories[i]->data;
+
+        std::vector<VSRTL_VT_U> targetState;
+        for (const auto& c : target.m_clockedComponents)
+            c->saveState(targetState);
+        if (targetState.size() != state.clockedState.size() || target.m_memories.size() != m_memories.size()) {
+            throw std::runtime_error("Forked design does not match the structure of the design");
+        }
+        target.loadState(state, m_cycleCount);
+    }
+
+    /**
+     * @brief forkLane
+     * Adds a lane, initialized with a copy of the state of the active lane, without re-elaborating the design.
+     * @returns the index of the new lane
+     */
+    unsigned forkLane() {
+        const unsigned lane = getLaneCount();
+        setLaneCount(lane + 1);
+        return lane;
     }
 
     /**
@@ -133,87 +614,366 @@ public:
             comp->initialize();
         }
 
-        if (detectCombinationalLoop()) {
-            throw std::runtime_error("Combinational loop detected in circuit");
+        const PortGraph graph(this);
+        const auto loops = CombinationalLoopDetector(graph).findLoops();
+        if (!loops.empty()) {
+            throw std::runtime_error("Combinational loop detected in circuit:" +
+                                     CombinationalLoopDetector::describe(loops));
         }
 
+        // Evaluate logic which solely depends on constants, prior to determining what must be propagated each cycle
+        foldConstantCones();
+
         // Traverse the graph to create the optimal propagation sequence
-        createPropagationStack();
+        createPropagationStack(graph);
+
+        // Lower the propagation sequence into a flat schedule
+        compilePropagationSchedule();
+
+        // Gather register state into the register bank; port slots are final once the schedule is compiled
+        createRegisterBank();
 
         // Reset the circuit to propagate initial state
         // @todo this should be changed, such that ports initially have a value of "X" until they are assigned
         reset();
 
         m_isVerifiedAndInitialized = true;
+        sampleBreakpoints();
     }
 
-    bool cycleUtil(SimComponent* c, std::map<SimComponent*, bool>& visited,
-                   std::map<SimComponent*, bool>& recurseStack) {
-        visited[c] = true;
-        recurseStack[c] = true;
-        if (!dynamic_cast<ClockedComponent*>(c))  // Graph is cut at registers
-            return false;
+    /**
+     * @brief findCombinationalLoops
+     * @returns the combinational loops of the design, each as the sequence of ports along the loop
+     */
+    std::vector<CombinationalLoopDetector::Loop> findCombinationalLoops() {
+        return CombinationalLoopDetector(PortGraph(this)).findLoops();
+    }
 
-        for (const auto& neighbour : m_componentGraph[c]) {
-            if (!visited[neighbour] && cycleUtil(neighbour, visited, recurseStack)) {
-                return true;
-            } else if (recurseStack[neighbour]) {
-                return true;
-            }
+    SparseArray* createMemory() {
+        if (m_lanes.size() > 1) {
+            throw std::runtime_error("Memories cannot be created while batch simulating");
         }
+        auto sptr = std::make_unique<SparseArray>();
+        auto* ptr = sptr.get();
+        m_memories.push_back(std::move(sptr));
+        return ptr;
+    }
+
+private:
+    /**
+     * @brief loadState
+     * Loads the clocked state and memory contents of @p state into the active lane, and propagates the design.
+     */
+    void loadState(DesignState& state, long long cycle) {
+        StateReader reader(state.clockedState);
+        for (const auto& c : m_clockedComponents)
+            c->restoreState(reader);
+        for (unsigned i = 0; i < m_memories.size(); i++)
+            m_memories[i]->data = std::move(state.memories[i].data);
+        m_cycleCount = cycle;
+        propagateDesign(PropagationMode::full);
+
+        clearHistory();
+        sampleBreakpoints();
+        publishChanges();
+    }
 
-        recurseStack[c] = false;
-        return false;
+    /**
+     * @brief recordHistory
+     * Called prior to clocking the design. Checkpoints the current state if the checkpoint interval has elapsed, or
+     * discards the reverse history if the upcoming cycle is not to be recorded.
+     */
+    void recordHistory(bool record) {
+        if (!record || m_lanes.size() > 1) {
+            clearHistory();
+            return;
+        }
+        if (m_forceCheckpoint || m_checkpoints.empty() ||
+            m_cycleCount - m_checkpoints.rbegin()->first >= m_checkpointSpacing) {
+            saveLane(m_checkpoints[m_cycleCount], true);
+            m_forceCheckpoint = false;
+            if (m_checkpoints.size() > m_maxCheckpoints)
+                thinCheckpoints();
+        }
+        if (m_journaling) {
+            m_journal.setRecording(true);
+            m_journal.beginCycle(m_cycleCount + 1);
+        }
     }
 
-    bool detectCombinationalLoop() {
-        std::map<SimComponent*, bool> visited;
-        for (const auto& cptr : m_componentGraph) {
-            visited[cptr.first] = false;
+    /**
+     * @brief thinCheckpoints
+     * Discards every other checkpoint, retaining the oldest checkpoint, and doubles the checkpoint spacing.
+     */
+    void thinCheckpoints() {
+        bool discard = true;
+        for (auto it = std::next(m_checkpoints.begin()); it != m_checkpoints.end(); discard = !discard) {
+            if (discard)
+                it = m_checkpoints.erase(it);
+            else
+                ++it;
         }
-        std::map<SimComponent*, bool> recurseStack;
+        m_checkpointSpacing *= 2;
+    }
 
+    void clearHistory() {
+        m_checkpoints.clear();
+        m_checkpointSpacing = m_checkpointInterval;
+        m_forceCheckpoint = false;
+        m_journal.clear();
+        m_journal.setRecording(false);
+    }
+
+    /**
+     * @brief checkBreakpoints
+     * Evaluates the breakpoints of the design against the active lane, following a clock cycle.
+     * @returns true if any breakpoint triggered
+     */
+    bool checkBreakpoints() {
+        m_breakpointHits.clear();
+        if (m_breakpoints.empty() || !m_isVerifiedAndInitialized)
+            return false;
+        if (!m_breakpoints.isCompiled()) {
+            m_breakpoints.compile(m_schedule, m_schedule.getValues());
+            return false;
+        }
+        return m_breakpoints.check(m_schedule.getValues(), m_breakpointHits);
+    }
+
+    /**
+     * @brief sampleBreakpoints
+     * Records the current values of all watched ports, following a modification of the state of the design which is
+     * not subject to breakpoints.
+     */
+    void sampleBreakpoints() {
+        m_breakpointHits.clear();
+        if (m_breakpoints.empty() || !m_isVerifiedAndInitialized)
+            return;
+        if (!m_breakpoints.isCompiled())
+            m_breakpoints.compile(m_schedule, m_schedule.getValues());
+        else
+            m_breakpoints.sample(m_schedule.getValues());
+    }
+
+    /**
+     * @brief publishChanges
+     * Publishes the ports recorded by batched change notification since the last publication.
+     */
+    void publishChanges() {
+        if (!m_schedule.batchedNotification())
+            return;
+        m_changeSet.ports.clear();
+        m_changeSet.components.clear();
+        m_schedule.takeChanges(m_changeSet.ports);
+        if (m_changeSet.ports.empty())
+            return;
+
+        std::set<Component*> components;
+        for (const auto& p : m_changeSet.ports) {
+            auto* c = p->getParent<Component>();
+            if (components.insert(c).second)
+                m_changeSet.components.push_back(c);
+        }
+        changesPublished.Emit(m_changeSet);
+    }
+
+    /**
+     * @brief foldConstantCones
+     * Constant components are evaluated once by Component::initialize(). Any combinational component whose inputs are
+     * all constant (or folded) is likewise evaluated once and marked as folded, such that it is excluded from the
+     * propagation stack. Folding proceeds through the fan-out of each folded component until no further components
+     * may be folded.
+     */
+    void foldConstantCones() {
+        std::vector<Component*> worklist;
         for (const auto& c : m_componentGraph) {
-            if (visited[c.first] == false) {
-                return cycleUtil(c.first, visited, recurseStack);
-            } else {
-                return false;
+            if (auto* comp = c.first->cast<Component>())
+                worklist.push_back(comp);
+        }
+
+        while (!worklist.empty()) {
+            auto* comp = worklist.back();
+            worklist.pop_back();
+            if (!comp->isFoldable())
+                continue;
+            comp->fold();
+            m_foldedComponents.push_back(comp);
+
+            // Folding may have made the components reading the folded outputs foldable. Output ports may forward
+            // through hierarchy boundaries, so all (transitive) sinks are visited.
+            std::vector<PortBase*> sinks;
+            for (const auto& p : comp->getPorts<SimPort::Direction::out, PortBase>())
+                sinks.push_back(p);
+            while (!sinks.empty()) {
+                auto* port = sinks.back();
+                sinks.pop_back();
+                for (const auto& sink : port->getOutputPorts<PortBase>()) {
+                    worklist.push_back(sink->getParent<Component>());
+                    sinks.push_back(sink);
+                }
             }
         }
-        return false;
     }
 
-    SparseArray* createMemory() {
-        auto sptr = std::make_unique<SparseArray>();
-        auto* ptr = sptr.get();
-        m_memories.push_back(std::move(sptr));
-        return ptr;
+    void clockLane() {
+        // Save register values (to correctly clock register -> register connections)
+        m_registerBank.clock(m_journal.recording() ? &m_journal : nullptr);
+        for (const auto& c : m_unbankedComponents)
+            c->save();
+        // Trimmed once the cycle has been recorded, such that the journal never exceeds its capacity
+        if (m_journal.recording())
+            m_journal.trim(m_journalCapacity);
+
+        propagateDesign();
+    }
+
+    void resetLane() {
+        // Reset all memories, clearing the sparse arrays and rewriting any initialization data
+        for (const auto& memory : m_memories) {
+            memory->reset();
+        }
+
+        // reset all registers
+        // propagate everything combinational
+        for (const auto& reg : m_clockedComponents)
+            reg->reset();
+        // All state has been reset - a full propagation is required regardless of the propagation mode
+        propagateDesign(PropagationMode::full);
+    }
+
+    /**
+     * @brief forEachLane
+     * Applies @p f to each lane of the design. The active lane is processed last, such that it is resident once all
+     * lanes have been processed. Signals are only emitted for the active lane; its port values are compared to the
+     * values of its own previous evaluation, so emitted change signals remain accurate.
+     */
+    template <typename F>
+    void forEachLane(const F& f) {
+        const unsigned nLanes = getLaneCount();
+        if (nLanes == 1) {
+            f();
+            return;
+        }
+
+        const unsigned active = m_activeLane;
+        const bool emitSignals = signalsEnabled();
+        setEnableSignals(false);
+        for (unsigned i = 1; i < nLanes; i++) {
+            activateLane((active + i) % nLanes);
+            f();
+        }
+        activateLane(active);
+        setEnableSignals(emitSignals);
+        f();
+    }
+
+    /**
+     * @brief saveLane
+     * Stores the resident state of the design in @p state. Unless @p copy is set, memory contents are moved out of the
+     * design, which must be followed by loading a lane.
+     */
+    void saveLane(DesignState& state, bool copy) {
+        state.portValues = m_schedule.getValues();
+        state.clockedState.clear();
+        for (const auto& c : m_clockedComponents)
+            c->saveState(state.clockedState);
+        state.memories.resize(m_memories.size());
+        for (unsigned i = 0; i < m_memories.size(); i++) {
+            if (copy)
+                state.memories[i] = *m_memories[i];
+            else
+                std::swap(state.memories[i], *m_memories[i]);
+        }
+    }
+
+    void loadLane(DesignState& state) {
+        std::copy(state.portValues.begin(), state.portValues.end(), m_schedule.getValues().begin());
+        StateReader reader(state.clockedState);
+        for (const auto& c : m_clockedComponents)
+            c->restoreState(reader);
+        for (unsigned i = 0; i < m_memories.size(); i++)
+            std::swap(state.memories[i], *m_memories[i]);
+    }
+
+    void activateLane(unsigned lane) {
+        if (lane == m_activeLane)
+            return;
+        saveLane(m_lanes[m_activeLane], false);
+        loadLane(m_lanes[lane]);
+        m_activeLane = lane;
+    }
+
+    void gatherClockedComponents(SimComponent* parent) {
+        for (const auto& c : parent->getSubComponents()) {
+            if (auto* cc = dynamic_cast<ClockedComponent*>(c))
+                m_clockedComponents.push_back(cc);
+            gatherClockedComponents(c);
+        }
     }
 
-private:
     void createComponentGraph() {
         m_componentGraph.clear();
         getComponentGraph(m_componentGraph);
 
         // Gather all registers in the design
         for (const auto& c : m_componentGraph) {
-            if (auto* cc = dynamic_cast<ClockedComponent*>(c.first)) {
-                m_clockedComponents.insert(cc);
-            }
             if (auto* rb = dynamic_cast<RegisterBase*>(c.first)) {
                 m_registers.insert(rb);
             }
         }
+        gatherClockedComponents(this);
+
+        // Reverse execution may only revert journaled deltas if all clocked state is journaled
+        m_journaling = std::all_of(m_clockedComponents.begin(), m_clockedComponents.end(),
+                                   [](ClockedComponent* c) { return c->journalsState(); });
+        if (m_journaling) {
+            for (const auto& cc : m_clockedComponents) {
+                cc->setJournal(&m_journal, m_journaledComponents.size());
+                m_journaledComponents.push_back(cc);
+            }
+        }
     }
 
-    unsigned int m_reverseStackCount = 0;
     std::map<SimComponent*, std::vector<SimComponent*>> m_componentGraph;
     std::set<RegisterBase*> m_registers;
-    std::set<ClockedComponent*> m_clockedComponents;
+    // Clocked components in hierarchy order, which is identical for all instances of a design
+    std::vector<ClockedComponent*> m_clockedComponents;
+    // Clocked components whose state is not held by the register bank
+    std::vector<ClockedComponent*> m_unbankedComponents;
+    RegisterBank m_registerBank;
     std::vector<std::unique_ptr<SparseArray>> m_memories;
 
     bool m_isVerifiedAndInitialized = false;
+    std::vector<Component*> m_foldedComponents;
+    ChangeSet m_changeSet;
+    bool m_headless = false;
+    bool m_reverseHistory = true;
+    // Reverse history; checkpoints of the design state, indexed by cycle
+    std::map<long long, DesignState> m_checkpoints;
+    unsigned m_checkpointInterval = 64;
+    unsigned m_checkpointSpacing = 64;
+    unsigned m_maxCheckpoints = 256;
+    bool m_forceCheckpoint = false;
+    // Reverse history; deltas of the clocked state of the most recent cycles
+    StateJournal m_journal;
+    std::vector<ClockedComponent*> m_journaledComponents;
+    size_t m_journalCapacity = 1 << 20;
+    bool m_journaling = false;
+    BreakpointEngine m_breakpoints;
+    std::vector<BreakpointId> m_breakpointHits;
+    std::set<const PortBase*> m_observedPorts;
     std::vector<PortBase*> m_propagationStack;
+    PropagationSchedule m_schedule;
+    PropagationMode m_propagationMode = PropagationMode::full;
+
+    std::unique_ptr<ThreadPool> m_threadPool;
+    unsigned m_parallelThreads = std::thread::hardware_concurrency();
+    unsigned m_parallelThreshold = 4096;
+    unsigned m_parallelGrainSize = 64;
+
+    // Batch simulation state. The entry of the active lane is stale; its state is resident in the design.
+    std::vector<DesignState> m_lanes;
+    unsigned m_activeLane = 0;
 };
 
 }  // namespace core
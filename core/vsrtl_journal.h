@@ -0,0 +1,126 @@
+#ifndef VSRTL_JOURNAL_H
+#define VSRTL_JOURNAL_H
+
+#include <deque>
+#include <vector>
+
+#include "vsrtl_defines.h"
+#include "vsrtl_state.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The StateJournal class
+ * A design-wide journal of the deltas of clocked state, indexed by cycle. Each clocked component records the state
+ * which it overwrites when clocked, if it changed. All deltas are stored in a single contiguous arena as
+ * [component, word count, words...] entries, with the entries of each cycle following the entries of the preceding
+ * cycle. Reverting a cycle visits the entries of that cycle once, newest first, and truncates the arena.
+ */
+class StateJournal {
+public:
+    void setRecording(bool recording) { m_recording = recording; }
+    bool recording() const { return m_recording; }
+
+    /**
+     * @brief beginCycle
+     * Starts recording the deltas of the clock transitioning the design into @p cycle.
+     */
+    void beginCycle(long long cycle) { m_cycles.push_back({cycle, m_base + m_arena.size()}); }
+
+    /**
+     * @brief record, recordValue
+     * Records a delta of @p component, consisting of the given words, respectively of a (possibly wide) state value.
+     */
+    template <typename... Words>
+    void record(unsigned component, Words... words) {
+        m_arena.push_back(component);
+        m_arena.push_back(sizeof...(Words));
+        (m_arena.push_back(words), ...);
+    }
+    template <typename T>
+    void recordValue(unsigned component, const T& value) {
+        m_arena.push_back(component);
+        const size_t count = m_arena.size();
+        m_arena.push_back(0);
+        saveValue(m_arena, value);
+        m_arena[count] = m_arena.size() - count - 1;
+    }
+
+    /**
+     * @brief covers
+     * @returns true if the journal holds the deltas of the clock transitioning the design into @p cycle
+     */
+    bool covers(long long cycle) const { return !m_cycles.empty() && m_cycles.back().cycle == cycle; }
+
+    /**
+     * @brief revertCycle
+     * Removes the deltas of the most recent cycle from the journal, calling @p revert(component, reader) for each.
+     * Deltas are reverted newest first, such that state which was overwritten multiple times within the cycle is
+     * restored to its value before the cycle.
+     */
+    template <typename F>
+    void revertCycle(const F& revert) {
+        const size_t begin = m_cycles.back().offset - m_base;
+        m_entries.clear();
+        for (size_t i = begin; i < m_arena.size(); i += 2 + m_arena[i + 1])
+            m_entries.push_back(i);
+        for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+            const size_t i = *it;
+            const unsigned nWords = m_arena[i + 1];
+            StateReader reader(m_arena.data() + i + 2, m_arena.data() + i + 2 + nWords);
+            revert(m_arena[i], reader);
+        }
+        m_arena.resize(begin);
+        m_cycles.pop_back();
+    }
+
+    /**
+     * @brief trim
+     * Discards the oldest cycles of the journal until at most @p maxWords words are journaled. The arena is compacted
+     * once the discarded words make up half of it.
+     */
+    void trim(size_t maxWords) {
+        while (!m_cycles.empty() && m_arena.size() - start() > maxWords)
+            m_cycles.pop_front();
+        const size_t start = this->start();
+        if (start > m_arena.size() / 2) {
+            m_arena.erase(m_arena.begin(), m_arena.begin() + start);
+            m_base += start;
+        }
+    }
+
+    void clear() {
+        m_arena.clear();
+        m_cycles.clear();
+        m_base = 0;
+    }
+
+    /**
+     * @brief size
+     * @returns the number of journaled words
+     */
+    size_t size() const { return m_arena.size() - start(); }
+
+private:
+    // Index of the oldest journaled word in the arena
+    size_t start() const { return m_cycles.empty() ? m_arena.size() : m_cycles.front().offset - m_base; }
+
+    struct Cycle {
+        long long cycle;
+        size_t offset;  // Offset of the cycle's first entry, including the words discarded from the arena
+    };
+
+    std::vector<VSRTL_VT_U> m_arena;
+    std::deque<Cycle> m_cycles;
+    // Number of words discarded from the front of the arena
+    size_t m_base = 0;
+    // Offsets of the entries of the cycle being reverted
+    std::vector<size_t> m_entries;
+    bool m_recording = false;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_JOURNAL_H
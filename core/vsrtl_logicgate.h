@@ -9,9 +9,22 @@ namespace core {
 template <unsigned int W, unsigned int nInputs>
 class LogicGate : public Component {
 public:
+    // Wide gates operate on all limbs of their operands
+    using value_type = std::conditional_t<isWideWidth(W), WideValue<W>, VSRTL_VT_U>;
+
     LogicGate(std::string name, SimComponent* parent) : Component(name, parent) {}
     OUTPUTPORT(out, W);
     INPUTPORTS(in, W, nInputs);
+
+protected:
+    bool describeBitwise(BitwiseFunction::Operator op, const PortBase* port, BitwiseFunction& function) const {
+        if (W != 1 || port != &out)
+            return false;
+        function.op = op;
+        for (const auto& i : in)
+            function.operands.push_back({i, 0});
+        return true;
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -19,13 +32,17 @@ class And : public LogicGate<W, nInputs> {
 public:
     SetGraphicsType(And) And(std::string name, SimComponent* parent) : LogicGate<W, nInputs>(name, parent) {
         this->out << [=] {
-            auto v = this->in[0]->template value<VSRTL_VT_U>();
+            auto v = this->in[0]->template value<typename LogicGate<W, nInputs>::value_type>();
             for (unsigned i = 1; i < this->in.size(); i++) {
-                v = v & this->in[i]->template value<VSRTL_VT_U>();
+                v = v & this->in[i]->template value<typename LogicGate<W, nInputs>::value_type>();
             }
             return v;
         };
     }
+
+    bool getBitwiseFunction(const PortBase* port, BitwiseFunction& function) const override {
+        return this->describeBitwise(BitwiseFunction::Operator::And, port, function);
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -34,13 +51,17 @@ public:
     SetGraphicsType(Or);
     Or(std::string name, SimComponent* parent) : LogicGate<W, nInputs>(name, parent) {
         this->out << [=] {
-            auto v = this->in[0]->template value<VSRTL_VT_U>();
+            auto v = this->in[0]->template value<typename LogicGate<W, nInputs>::value_type>();
             for (unsigned i = 1; i < this->in.size(); i++) {
-                v = v | this->in[i]->template value<VSRTL_VT_U>();
+                v = v | this->in[i]->template value<typename LogicGate<W, nInputs>::value_type>();
             }
             return v;
         };
     }
+
+    bool getBitwiseFunction(const PortBase* port, BitwiseFunction& function) const override {
+        return this->describeBitwise(BitwiseFunction::Operator::Or, port, function);
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -49,13 +70,17 @@ public:
     SetGraphicsType(Xor);
     Xor(std::string name, SimComponent* parent) : LogicGate<W, nInputs>(name, parent) {
         this->out << [=] {
-            auto v = this->in[0]->template value<VSRTL_VT_U>();
+            auto v = this->in[0]->template value<typename LogicGate<W, nInputs>::value_type>();
             for (unsigned i = 1; i < this->in.size(); i++) {
-                v = v ^ this->in[i]->template value<VSRTL_VT_U>();
+                v = v ^ this->in[i]->template value<typename LogicGate<W, nInputs>::value_type>();
             }
             return v;
         };
     }
+
+    bool getBitwiseFunction(const PortBase* port, BitwiseFunction& function) const override {
+        return this->describeBitwise(BitwiseFunction::Operator::Xor, port, function);
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
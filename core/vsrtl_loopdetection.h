@@ -0,0 +1,148 @@
+#ifndef VSRTL_LOOPDETECTION_H
+#define VSRTL_LOOPDETECTION_H
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "vsrtl_portgraph.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The CombinationalLoopDetector class
+ * Finds combinational loops in the port graph of a component hierarchy (see PortGraph).
+ *
+ * The strongly connected components of the graph are found through an iterative formulation of Tarjan's algorithm,
+ * in time linear in the number of ports and connections. Each strongly connected component containing a cycle is
+ * reported as one loop, given as the sequence of ports along a shortest cycle through the component.
+ */
+class CombinationalLoopDetector {
+public:
+    using Loop = std::vector<PortBase*>;
+
+    explicit CombinationalLoopDetector(const PortGraph& graph) : m_graph(graph) {}
+
+    std::vector<Loop> findLoops() {
+        const unsigned n = m_graph.size();
+        constexpr unsigned unvisited = ~0u;
+        std::vector<unsigned> index(n, unvisited), lowlink(n, 0);
+        std::vector<bool> onStack(n, false);
+        std::vector<unsigned> stack;
+        // Explicit call stack of (node, index of the next successor to visit)
+        std::vector<std::pair<unsigned, unsigned>> calls;
+        std::vector<Loop> loops;
+        unsigned nextIndex = 0;
+
+        for (unsigned root = 0; root < n; root++) {
+            if (index[root] != unvisited)
+                continue;
+            calls.push_back({root, 0});
+            while (!calls.empty()) {
+                auto& [v, edge] = calls.back();
+                const unsigned* successors = m_graph.successorsBegin(v);
+                if (edge == 0) {
+                    index[v] = lowlink[v] = nextIndex++;
+                    stack.push_back(v);
+                    onStack[v] = true;
+                }
+                if (successors + edge < m_graph.successorsEnd(v)) {
+                    const unsigned w = successors[edge++];
+                    if (index[w] == unvisited) {
+                        calls.push_back({w, 0});
+                    } else if (onStack[w]) {
+                        lowlink[v] = std::min(lowlink[v], index[w]);
+                    }
+                    continue;
+                }
+
+                // All successors of v are visited; v roots a strongly connected component if its lowlink is its own
+                const unsigned node = v;
+                calls.pop_back();
+                if (!calls.empty())
+                    lowlink[calls.back().first] = std::min(lowlink[calls.back().first], lowlink[node]);
+                if (lowlink[node] != index[node])
+                    continue;
+                const auto begin = std::find(stack.rbegin(), stack.rend(), node).base() - 1;
+                std::vector<unsigned> scc(begin, stack.end());
+                stack.erase(begin, stack.end());
+                for (const auto& s : scc)
+                    onStack[s] = false;
+                if (scc.size() > 1 || m_graph.hasEdge(node, node))
+                    loops.push_back(extractLoop(scc));
+            }
+        }
+        return loops;
+    }
+
+    /**
+     * @brief portPath
+     * @returns the hierarchical name of @p port, ie. "design.component.subcomponent:port"
+     */
+    static std::string portPath(const PortBase* port) {
+        std::string path = port->getName();
+        char separator = ':';
+        for (const SimBase* parent = port->getParent(); parent; parent = parent->getParent()) {
+            path = parent->getName() + separator + path;
+            separator = '.';
+        }
+        return path;
+    }
+
+    /**
+     * @brief describe
+     * @returns a description of @p loops, listing the ports of each loop in order, starting and ending at the same port
+     */
+    static std::string describe(const std::vector<Loop>& loops) {
+        std::string description;
+        for (unsigned i = 0; i < loops.size(); i++) {
+            description += "\nLoop " + std::to_string(i + 1) + ": ";
+            for (const auto& port : loops[i])
+                description += portPath(port) + " -> ";
+            description += portPath(loops[i].front());
+        }
+        return description;
+    }
+
+private:
+    /**
+     * @brief extractLoop
+     * Breadth-first search within @p scc from its first node back to itself.
+     */
+    Loop extractLoop(const std::vector<unsigned>& scc) {
+        const unsigned start = scc.front();
+        std::unordered_map<unsigned, unsigned> predecessor;
+        for (const auto& s : scc)
+            predecessor[s] = ~0u;
+        std::vector<unsigned> queue = {start};
+        for (unsigned head = 0; head < queue.size(); head++) {
+            const unsigned v = queue[head];
+            for (auto it = m_graph.successorsBegin(v); it != m_graph.successorsEnd(v); ++it) {
+                const unsigned w = *it;
+                auto pred = predecessor.find(w);
+                if (pred == predecessor.end() || (pred->second != ~0u && w != start))
+                    continue;
+                pred->second = v;
+                if (w == start) {
+                    Loop loop;
+                    for (unsigned u = v; u != start; u = predecessor.at(u))
+                        loop.push_back(m_graph.port(u));
+                    loop.push_back(m_graph.port(start));
+                    std::reverse(loop.begin(), loop.end());
+                    return loop;
+                }
+                queue.push_back(w);
+            }
+        }
+        return {m_graph.port(start)};
+    }
+
+    const PortGraph& m_graph;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_LOOPDETECTION_H
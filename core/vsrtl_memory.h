@@ -14,12 +14,6 @@
 namespace vsrtl {
 namespace core {
 
-struct MemoryEviction {
-    VSRTL_VT_U addr;
-    VSRTL_VT_U data;
-    VSRTL_VT_U width;
-};
-
 template <unsigned addrWidth, unsigned dataWidth, bool byteIndexed = true>
 class BaseMemory {
 public:
@@ -46,47 +40,49 @@ class WrMemory : public ClockedComponent, public BaseMemory<addrWidth, dataWidth
 public:
     SetGraphicsType(Component);
     WrMemory(std::string name, SimComponent* parent) : ClockedComponent(name, parent) {}
-    void reset() override { m_reverseStack.clear(); }
+    void reset() override {}
 
     void save() override {
+        if (!static_cast<bool>(wr_en))
+            return;
         const VSRTL_VT_U addr_v = addr.template value<VSRTL_VT_U>();
         const VSRTL_VT_U data_in_v = data_in.template value<VSRTL_VT_U>();
-        const VSRTL_VT_U data_out_v = this->read(addr_v);
-        auto ev = MemoryEviction({addr_v, data_out_v, wr_width.uValue()});
-        saveToStack(ev);
-        if (static_cast<bool>(wr_en))
-            this->write(addr_v, data_in_v, wr_width.uValue());
-    }
-
-    void reverse() override {
-        if (m_reverseStack.size() > 0) {
-            auto lastEviction = m_reverseStack.front();
-            this->write(lastEviction.addr, lastEviction.data, lastEviction.width);
-            m_reverseStack.pop_front();
+        const VSRTL_VT_U width = wr_width.uValue();
+        if (auto* j = journal()) {
+            // Only writes which modify the memory are journaled
+            const VSRTL_VT_U mask = width >= sizeof(VSRTL_VT_U) ? ~VSRTL_VT_U(0) : (VSRTL_VT_U(1) << (width * 8)) - 1;
+            const VSRTL_VT_U previous = this->m_memory->template readMem<byteIndexed>(addr_v, width);
+            if (previous == (data_in_v & mask))
+                return;
+            j->record(journalIndex(), addr_v, previous, width);
         }
+        this->write(addr_v, data_in_v, width);
     }
 
     void forceValue(VSRTL_VT_U addr, VSRTL_VT_U value) override { this->write(addr, value); }
 
+    // The memory contents are owned by the design (see ADDRESSSPACE); the write port itself holds no state
+    void saveState(std::vector<VSRTL_VT_U>&) const override {}
+    void restoreState(StateReader&) override {}
+
+    bool journalsState() const override { return true; }
+    void revert(StateReader& delta) override {
+        const VSRTL_VT_U address = delta.read();
+        const VSRTL_VT_U value = delta.read();
+        this->write(address, value, delta.read());
+    }
+
     INPUTPORT(addr, addrWidth);
     INPUTPORT(data_in, dataWidth);
     INPUTPORT(wr_width, ceillog2(dataWidth / 8 + 1));  // # bytes
     INPUTPORT(wr_en, 1);
-
-    void saveToStack(MemoryEviction v) {
-        m_reverseStack.push_front(v);
-        if (m_reverseStack.size() > reverseStackSize()) {
-            m_reverseStack.pop_back();
-        }
-    }
-
-    std::deque<MemoryEviction> m_reverseStack;
 };
 
 template <unsigned int addrWidth, unsigned int dataWidth, bool byteIndexed = true>
 class MemorySyncRd : public WrMemory<addrWidth, dataWidth, byteIndexed> {
 public:
     MemorySyncRd(std::string name, SimComponent* parent) : WrMemory<addrWidth, dataWidth, byteIndexed>(name, parent) {
+        this->setStateDependent();
         data_out << [=] { return this->read(this->addr.template value<VSRTL_VT_U>()); };
     }
 
@@ -104,6 +100,7 @@ class RdMemory : public Component, public BaseMemory<addrWidth, dataWidth, byteI
 public:
     SetGraphicsType(ClockedComponent);
     RdMemory(std::string name, SimComponent* parent) : Component(name, parent) {
+        setStateDependent();
         data_out << [=] { return this->read(addr.template value<VSRTL_VT_U>()); };
     }
 
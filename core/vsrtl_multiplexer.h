@@ -24,7 +24,11 @@ class Multiplexer : public MultiplexerBase {
 public:
     Multiplexer(std::string name, SimComponent* parent) : MultiplexerBase(name, parent) {
         setSpecialPort("select", &select);
-        out << [=] { return ins.at(select.template value<VSRTL_VT_U>())->template value<VSRTL_VT_U>(); };
+        if constexpr (isWideWidth(W)) {
+            out << [=] { return ins.at(select.template value<VSRTL_VT_U>())->wideValue(); };
+        } else {
+            out << [=] { return ins.at(select.template value<VSRTL_VT_U>())->template value<VSRTL_VT_U>(); };
+        }
     }
 
     std::vector<PortBase*> getIns() override {
@@ -76,7 +80,11 @@ public:
         for (auto v : E_t::_values()) {
             m_enumToPort[v] = this->ins.at(v);
         }
-        out << [=] { return ins.at(select.uValue())->template value<VSRTL_VT_U>(); };
+        if constexpr (isWideWidth(W)) {
+            out << [=] { return ins.at(select.uValue())->wideValue(); };
+        } else {
+            out << [=] { return ins.at(select.uValue())->template value<VSRTL_VT_U>(); };
+        }
     }
 
     Port<W>& get(unsigned enumIdx) {
@@ -2,6 +2,8 @@
 #define VSRTL_SIGNAL_H
 
 #include <limits.h>
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <initializer_list>
@@ -11,13 +13,19 @@
 
 #include "../interface/vsrtl_binutils.h"
 #include "vsrtl_defines.h"
+#include "vsrtl_propagationfunction.h"
+#include "vsrtl_widevalue.h"
 
 namespace vsrtl {
 namespace core {
 
 class Component;
+class PropagationSchedule;
+class RegisterBank;
 
-enum class PropagationState { unpropagated, propagated, constant };
+// folded: The port is part of a cone of combinational logic which solely depends on constants, and has been evaluated
+// once during design initialization.
+enum class PropagationState { unpropagated, propagated, constant, folded };
 
 /**
  * @brief The PortBase class
@@ -29,13 +37,28 @@ public:
 
     bool isPropagated() const { return m_propagationState != PropagationState::unpropagated; }
     bool isConstant() const override { return m_propagationState == PropagationState::constant; }
+    bool isFolded() const { return m_propagationState == PropagationState::folded; }
+    bool hasConstantValue() const { return isConstant() || isFolded(); }
+
+    /**
+     * @brief isPruned
+     * A port is pruned from the propagation schedule of a headless design if it neither affects the state of the
+     * design nor is observed. The value of a pruned port is stale; reading it through uValue() or sValue() observes
+     * the port, bringing it back into the propagation schedule.
+     */
+    bool isPruned() const { return m_pruned; }
     void resetPropagation() {
-        m_propagationState =
-            m_propagationState == PropagationState::constant ? m_propagationState : PropagationState::unpropagated;
+        m_propagationState = hasConstantValue() ? m_propagationState : PropagationState::unpropagated;
     }
 
-    virtual void propagate(std::vector<PortBase*>& propagationStack) = 0;
+    /**
+     * @brief getLimbCount
+     * @returns the number of VSRTL_VT_U words occupied by the value of this port
+     */
+    unsigned int getLimbCount() const { return limbCount(getWidth()); }
+
     virtual void propagateConstant() = 0;
+    virtual void propagateFolded() = 0;
     virtual void setPortValue() = 0;
     virtual bool isConnected() const = 0;
 
@@ -51,14 +74,69 @@ public:
     }
 
 protected:
+    friend class PropagationSchedule;
+    friend class RegisterBank;
+
+    /**
+     * @brief relocate
+     * Moves the storage of this port's value to @p slot. Called by the propagation schedule when the design gathers
+     * all port values into a single contiguous array.
+     */
+    void relocate(VSRTL_VT_U* slot) {
+        std::copy(m_slot, m_slot + getLimbCount(), slot);
+        m_slot = slot;
+    }
+
     PropagationState m_propagationState = PropagationState::unpropagated;
+
+    // Port values are initialized to 0xdeadbeef for error detection reasons. In reality (in a circuit), this would
+    // not be the case - the entire circuit is reset when the registers are reset (to 0), and the circuit state is
+    // then propagated.
+    VSRTL_VT_U m_value = 0xdeadbeef;
+
+    // Storage location of the port value. Refers to m_value (or the limb storage of wide ports) until the design has
+    // compiled its propagation schedule, after which it refers to this port's slots in the design-wide port value
+    // array. Wide ports occupy getLimbCount() consecutive slots, least significant limb first.
+    VSRTL_VT_U* m_slot = &m_value;
+
+    PropagationFunction m_propagationFunction;
+
+    bool m_pruned = false;
+    // Set while the port is recorded in the batched change set of the propagation schedule
+    bool m_dirty = false;
+
+    void observeIfPruned() const {
+        if (m_pruned) {
+            const_cast<PortBase*>(this)->getDesign()->observe(this);
+        }
+    }
 };
 
+/**
+ * @brief The WidePortStorage struct
+ * Initial limb storage of wide ports. Empty for narrow ports, which store their value in PortBase::m_value.
+ */
+template <unsigned int W, bool wide = isWideWidth(W)>
+struct WidePortStorage {};
+
 template <unsigned int W>
-class Port : public PortBase {
+struct WidePortStorage<W, true> {
+    std::array<VSRTL_VT_U, limbCount(W)> m_limbs;
+};
+
+template <unsigned int W>
+class Port : public PortBase, private WidePortStorage<W> {
 public:
-    Port(std::string name, SimComponent* parent) : PortBase(name, parent) {}
+    static constexpr bool isWide = isWideWidth(W);
+
+    Port(std::string name, SimComponent* parent) : PortBase(name, parent) {
+        if constexpr (isWide) {
+            this->m_limbs.fill(m_value);
+            m_slot = this->m_limbs.data();
+        }
+    }
     bool isConnected() const override { return m_inputPort != nullptr || m_propagationFunction; }
+    size_t getFootprint() const override { return sizeof(*this) + getAllocatedFootprint(); }
 
     // Port connections are doubly linked
     void operator>>(Port<W>& toThis) {
@@ -77,25 +155,56 @@ public:
             *this >> *p;
     }
 
+    /**
+     * @brief value
+     * Wide ports may be read as WideValue<W>; reading a wide port as a scalar yields its least significant word.
+     */
     template <typename T>
     T value() const {
-        return static_cast<T>(signextend<T, W>(m_value));
+        if constexpr (std::is_same<T, WideValue<W>>::value) {
+            return WideValue<W>::fromLimbs(m_slot);
+        } else if constexpr (isWide) {
+            return static_cast<T>(*m_slot);
+        } else {
+            return static_cast<T>(signextend<T, W>(*m_slot));
+        }
     }
 
-    VSRTL_VT_U uValue() const override { return value<VSRTL_VT_U>(); }
-    VSRTL_VT_S sValue() const override { return value<VSRTL_VT_S>(); }
+    WideValue<W> wideValue() const { return value<WideValue<W>>(); }
+
+    VSRTL_VT_U uValue() const override {
+        observeIfPruned();
+        return value<VSRTL_VT_U>();
+    }
+    VSRTL_VT_S sValue() const override {
+        observeIfPruned();
+        return value<VSRTL_VT_S>();
+    }
     unsigned int getWidth() const override { return W; }
 
-    explicit operator VSRTL_VT_S() const { return signextend<VSRTL_VT_S, W>(m_value); }
+    explicit operator VSRTL_VT_S() const { return value<VSRTL_VT_S>(); }
 
     void setPortValue() override {
-        auto prePropagateValue = m_value;
+        if constexpr (isWide) {
+            bool valueChanged;
+            if (m_propagationFunction) {
+                valueChanged = m_propagationFunction.evaluateWide(m_slot);
+            } else {
+                valueChanged = getInputPort<Port<W>>()->wideValue().store(m_slot);
+            }
+            if (valueChanged && getDesign()->signalsEnabled()) {
+                changed.Emit();
+            }
+            return;
+        }
+
+        auto prePropagateValue = *m_slot;
         if (m_propagationFunction) {
-            m_value = m_propagationFunction();
+            *m_slot = m_propagationFunction();
         } else {
-            m_value = getInputPort<Port<W>>()->template value<VSRTL_VT_U>();
+            *m_slot = getInputPort<Port<W>>()->template value<VSRTL_VT_U>();
         }
-        if (m_value != prePropagateValue) {
+        if (*m_slot != prePropagateValue) {
             // Signal all watcher of this port that the port value changed
             if (getDesign()->signalsEnabled()) {
                 changed.Emit();
@@ -103,16 +212,6 @@ public:
         }
     }
 
-    void propagate(std::vector<PortBase*>& propagationStack) override {
-        if (m_propagationState == PropagationState::unpropagated) {
-            propagationStack.push_back(this);
-            // Propagate the value to the ports which connect to this
-            for (const auto& port : getOutputPorts<Port<W>>())
-                port->propagate(propagationStack);
-            m_propagationState = PropagationState::propagated;
-        }
-    }
-
     void propagateConstant() override {
         m_propagationState = PropagationState::constant;
         setPortValue();
@@ -120,24 +219,28 @@ public:
             port->propagateConstant();
     }
 
-    void operator<<(std::function<VSRTL_VT_U()>&& propagationFunction) {
+    void propagateFolded() override {
+        m_propagationState = PropagationState::folded;
+        setPortValue();
+        for (const auto& port : getOutputPorts<Port<W>>())
+            port->propagateFolded();
+    }
+
+    template <typename F>
+    void operator<<(F&& propagationFunction) {
         if (m_propagationFunction) {
             throw std::runtime_error("Propagation function reassignment prohibited");
         }
-        m_propagationFunction = propagationFunction;
+        if constexpr (isWide) {
+            m_propagationFunction.template assignWide<W>(std::forward<F>(propagationFunction));
+        } else {
+            m_propagationFunction.assign(std::forward<F>(propagationFunction));
+        }
     }
 
     // Value access operators
-    explicit operator VSRTL_VT_U() const { return m_value; }
-    explicit operator bool() const { return m_value & 0b1; }
-
-protected:
-    // Port values are initialized to 0xdeadbeef for error detection reasons. In reality (in a circuit), this would
-    // not be the case - the entire circuit is reset when the registers are reset (to 0), and the circuit state is
-    // then propagated.
-    VSRTL_VT_U m_value = 0xdeadbeef;
-
-    std::function<VSRTL_VT_U()> m_propagationFunction = {};
+    explicit operator VSRTL_VT_U() const { return *m_slot; }
+    explicit operator bool() const { return *m_slot & 0b1; }
 };
 
 template <unsigned int W, typename E_t>
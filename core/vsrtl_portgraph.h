@@ -0,0 +1,101 @@
+#ifndef VSRTL_PORTGRAPH_H
+#define VSRTL_PORTGRAPH_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "vsrtl_component.h"
+#include "vsrtl_port.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The PortGraph class
+ * The flattened dependency graph of the ports of a component hierarchy. The graph has an edge for each connection
+ * between two ports, and an edge from each input port (and sensitivity list entry) of a combinational component to
+ * each of its output ports which is not driven through a connection. Synchronous components cut the graph; their
+ * outputs are a function of their state.
+ * Ports are numbered in hierarchy order, and the successors of each port are stored contiguously (CSR format).
+ */
+class PortGraph {
+public:
+    explicit PortGraph(SimComponent* root) {
+        gatherPorts(root);
+        buildGraph();
+    }
+
+    unsigned size() const { return m_ports.size(); }
+    PortBase* port(unsigned index) const { return m_ports[index]; }
+    const std::vector<PortBase*>& ports() const { return m_ports; }
+
+    /**
+     * @brief successors
+     * @returns the range of indices of the ports which depend on the port at @p index
+     */
+    const unsigned* successorsBegin(unsigned index) const { return m_edges.data() + m_edgeOffsets[index]; }
+    const unsigned* successorsEnd(unsigned index) const { return m_edges.data() + m_edgeOffsets[index + 1]; }
+
+    bool hasEdge(unsigned from, unsigned to) const {
+        return std::find(successorsBegin(from), successorsEnd(from), to) != successorsEnd(from);
+    }
+
+private:
+    void gatherPorts(SimComponent* c) {
+        if (auto* comp = c->cast<Component>()) {
+            for (const auto& p : comp->getAllPorts<PortBase>()) {
+                m_indices[p] = m_ports.size();
+                m_ports.push_back(p);
+            }
+            m_components.push_back(comp);
+        }
+        for (const auto& sc : c->getSubComponents())
+            gatherPorts(sc);
+    }
+
+    void buildGraph() {
+        std::vector<std::vector<unsigned>> adjacency(m_ports.size());
+        auto addEdge = [&](const PortBase* from, const PortBase* to) {
+            const auto fromIt = m_indices.find(from);
+            const auto toIt = m_indices.find(to);
+            if (fromIt != m_indices.end() && toIt != m_indices.end())
+                adjacency[fromIt->second].push_back(toIt->second);
+        };
+
+        for (unsigned i = 0; i < m_ports.size(); i++) {
+            for (const auto& sink : m_ports[i]->getOutputPorts())
+                addEdge(m_ports[i], sink->cast<PortBase>());
+        }
+        for (const auto& c : m_components) {
+            if (c->isSynchronous())
+                continue;
+            const auto inputs = c->getPorts<SimPort::Direction::in, PortBase>();
+            for (const auto& out : c->getPorts<SimPort::Direction::out, PortBase>()) {
+                if (out->getInputPort())
+                    continue;
+                for (const auto& in : inputs)
+                    addEdge(in, out);
+                for (const auto& sens : c->getSensitivityList())
+                    addEdge(sens, out);
+            }
+        }
+
+        m_edgeOffsets.push_back(0);
+        for (const auto& successors : adjacency) {
+            m_edges.insert(m_edges.end(), successors.begin(), successors.end());
+            m_edgeOffsets.push_back(m_edges.size());
+        }
+    }
+
+    std::vector<PortBase*> m_ports;
+    std::vector<Component*> m_components;
+    std::unordered_map<const PortBase*, unsigned> m_indices;
+    std::vector<unsigned> m_edges;
+    std::vector<unsigned> m_edgeOffsets;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_PORTGRAPH_H
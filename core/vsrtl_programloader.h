@@ -0,0 +1,268 @@
+#ifndef VSRTL_PROGRAMLOADER_H
+#define VSRTL_PROGRAMLOADER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "vsrtl_defines.h"
+#include "vsrtl_sparsearray.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The MappedFile class
+ * The contents of a file. On POSIX systems, the file is mapped privately into memory, such that it is read lazily by
+ * the operating system and modifications of the mapping are never written back to the file. Elsewhere, the file is
+ * read into a buffer.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open '" + path + "'");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            m_size = st.st_size;
+            void* mapping = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            m_data = mapping == MAP_FAILED ? nullptr : static_cast<uint8_t*>(mapping);
+        }
+        ::close(fd);
+        if (m_size > 0 && !m_data) {
+            throw std::runtime_error("Could not map '" + path + "'");
+        }
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Could not open '" + path + "'");
+        }
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (m_data)
+            ::munmap(m_data, m_size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    std::vector<uint8_t> m_buffer;
+#endif
+};
+
+// Program loaders. Each loader writes the contents of a program file into the initialization image of an address
+// space, which is loaded once the design is reset (see SparseArray::addInitializationMemory). Whole pages of flat
+// binaries and ELF segments are mapped directly from the file without copying, and are shared copy-on-write by the
+// address space. All loaders throw std::runtime_error on malformed files, leaving the initialization image unmodified.
+namespace detail {
+
+/**
+ * @brief mapSegment
+ * Maps @p size bytes of @p file, starting at @p offset, into @p image at @p address. Pages which lie entirely within
+ * the segment reference the file; partial pages at the boundaries of the segment are copied.
+ */
+inline void mapSegment(MemoryPages& image, const std::shared_ptr<MappedFile>& file, size_t offset, size_t size,
+                       VSRTL_VT_U address) {
+    if (offset > file->size() || size > file->size() - offset) {
+        throw std::runtime_error("Program segment exceeds the end of the file");
+    }
+    if (size > 0 && size - 1 > ~VSRTL_VT_U(0) - address) {
+        throw std::runtime_error("Program segment exceeds the address space");
+    }
+    uint8_t* bytes = file->data() + offset;
+    while (size > 0) {
+        const unsigned pageOffset = address & (MemoryPages::pageSize - 1);
+        size_t chunk = MemoryPages::pageSize - pageOffset;
+        if (pageOffset == 0 && size >= MemoryPages::pageSize) {
+            // Aliases the file mapping, keeping the file mapped for as long as the page is referenced
+            image.map(address, std::shared_ptr<MemoryPages::Page>(file, reinterpret_cast<MemoryPages::Page*>(bytes)));
+        } else {
+            chunk = std::min(chunk, size);
+            image.write(address, bytes, chunk);
+        }
+        address += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+}
+
+template <typename T>
+T readLE(const MappedFile& file, size_t offset) {
+    if (offset > file.size() || sizeof(T) > file.size() - offset) {
+        throw std::runtime_error("Unexpected end of ELF file");
+    }
+    T value = 0;
+    for (unsigned i = 0; i < sizeof(T); i++)
+        value |= static_cast<T>(file.data()[offset + i]) << (i * 8);
+    return value;
+}
+
+inline unsigned hexDigit(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    throw std::runtime_error("Invalid hexadecimal digit in Intel HEX file");
+}
+
+}  // namespace detail
+
+/**
+ * @brief loadBinary
+ * Loads the flat binary file at @p path into @p memory, starting at @p address.
+ */
+inline void loadBinary(SparseArray& memory, const std::string& path, VSRTL_VT_U address = 0) {
+    auto file = std::make_shared<MappedFile>(path);
+    MemoryPages image = memory.initializationImage;
+    detail::mapSegment(image, file, 0, file->size(), address);
+    memory.initializationImage = std::move(image);
+}
+
+/**
+ * @brief loadIntelHex
+ * Loads the Intel HEX file at @p path into @p memory. Data records are placed at their (extended segment or extended
+ * linear) addresses.
+ */
+inline void loadIntelHex(SparseArray& memory, const std::string& path) {
+    MappedFile file(path);
+    const char* it = reinterpret_cast<const char*>(file.data());
+    const char* end = it + file.size();
+    auto byte = [&] {
+        if (end - it < 2) {
+            throw std::runtime_error("Truncated Intel HEX record");
+        }
+        const unsigned value = detail::hexDigit(it[0]) << 4 | detail::hexDigit(it[1]);
+        it += 2;
+        return static_cast<uint8_t>(value);
+    };
+
+    MemoryPages image = memory.initializationImage;
+    VSRTL_VT_U base = 0;
+    std::vector<uint8_t> data;
+    bool eof = false;
+    while (!eof) {
+        while (it != end && *it != ':')
+            it++;
+        if (it == end) {
+            throw std::runtime_error("Intel HEX file lacks an end of file record");
+        }
+        it++;
+        const uint8_t count = byte();
+        const uint8_t addrHi = byte();
+        const uint8_t addrLo = byte();
+        const uint8_t type = byte();
+        uint8_t checksum = count + addrHi + addrLo + type;
+        data.resize(count);
+        for (auto& b : data) {
+            b = byte();
+            checksum += b;
+        }
+        if (static_cast<uint8_t>(checksum + byte()) != 0) {
+            throw std::runtime_error("Invalid checksum in Intel HEX record");
+        }
+
+        switch (type) {
+            case 0x00:
+                image.write(base + (addrHi << 8 | addrLo), data.data(), data.size());
+                break;
+            case 0x01:
+                eof = true;
+                break;
+            case 0x02:
+            case 0x04:
+                if (count != 2) {
+                    throw std::runtime_error("Invalid extended address record in Intel HEX file");
+                }
+                base = (data[0] << 8 | data[1]) << (type == 0x02 ? 4 : 16);
+                break;
+            case 0x03:
+            case 0x05:
+                // Start address records do not affect memory contents
+                break;
+            default:
+                throw std::runtime_error("Unknown Intel HEX record type");
+        }
+    }
+    memory.initializationImage = std::move(image);
+}
+
+/**
+ * @brief loadElf
+ * Loads the loadable segments of the little-endian 32- or 64-bit ELF file at @p path into @p memory, at the physical
+ * load addresses of the segments. Bytes of a segment beyond its file size (ie. .bss) are left unallocated, and thus
+ * read as 0.
+ * @returns the entry point of the program
+ */
+inline VSRTL_VT_U loadElf(SparseArray& memory, const std::string& path) {
+    using detail::readLE;
+    auto file = std::make_shared<MappedFile>(path);
+    const MappedFile& f = *file;
+    if (f.size() < 16 || f.data()[0] != 0x7f || f.data()[1] != 'E' || f.data()[2] != 'L' || f.data()[3] != 'F') {
+        throw std::runtime_error("'" + path + "' is not an ELF file");
+    }
+    const bool is64 = f.data()[4] == 2;
+    if ((f.data()[4] != 1 && !is64) || f.data()[5] != 1) {
+        throw std::runtime_error("Only little-endian 32- and 64-bit ELF files are supported");
+    }
+
+    auto checkAddress = [](uint64_t address) {
+        if (address > ~VSRTL_VT_U(0)) {
+            throw std::runtime_error("ELF address exceeds the address space");
+        }
+        return static_cast<VSRTL_VT_U>(address);
+    };
+    const uint64_t entry = is64 ? readLE<uint64_t>(f, 24) : readLE<uint32_t>(f, 24);
+    const uint64_t phoff = is64 ? readLE<uint64_t>(f, 32) : readLE<uint32_t>(f, 28);
+    const unsigned phentsize = readLE<uint16_t>(f, is64 ? 54 : 42);
+    const unsigned phnum = readLE<uint16_t>(f, is64 ? 56 : 44);
+
+    MemoryPages image = memory.initializationImage;
+    for (unsigned i = 0; i < phnum; i++) {
+        const size_t ph = phoff + i * phentsize;
+        constexpr uint32_t PT_LOAD = 1;
+        if (readLE<uint32_t>(f, ph) != PT_LOAD)
+            continue;
+        const uint64_t offset = is64 ? readLE<uint64_t>(f, ph + 8) : readLE<uint32_t>(f, ph + 4);
+        const uint64_t paddr = is64 ? readLE<uint64_t>(f, ph + 24) : readLE<uint32_t>(f, ph + 12);
+        const uint64_t filesz = is64 ? readLE<uint64_t>(f, ph + 32) : readLE<uint32_t>(f, ph + 16);
+        detail::mapSegment(image, file, offset, filesz, checkAddress(paddr));
+    }
+    memory.initializationImage = std::move(image);
+    return checkAddress(entry);
+}
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_PROGRAMLOADER_H
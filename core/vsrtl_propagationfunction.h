@@ -0,0 +1,144 @@
+#ifndef VSRTL_PROPAGATIONFUNCTION_H
+#define VSRTL_PROPAGATIONFUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "vsrtl_defines.h"
+#include "vsrtl_widevalue.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The PropagationFunction class
+ * Type-erased storage for the propagation function of a port. Unlike std::function, closures which fit within the
+ * inline buffer (such as the [=] lambdas capturing 'this' and a few values, used by all built-in components) are
+ * stored in place, without heap allocation. Invocation goes through a single function pointer to a trampoline which is
+ * instantiated for the concrete closure type, allowing the compiler to inline the closure body and the port value
+ * accesses within it.
+ * Larger closures are heap allocated, such that any callable returning a value convertible to VSRTL_VT_U is accepted.
+ * Propagation functions of wide ports (see isWideWidth()) are assigned through assignWide(), and are invoked through a
+ * wide invoker which writes the resulting limbs to the port's value slots.
+ */
+class PropagationFunction {
+public:
+    using Invoker = VSRTL_VT_U (*)(const void*);
+    // Evaluates the function into the limbs at the destination, returning whether the stored value changed
+    using WideInvoker = bool (*)(const void*, VSRTL_VT_U*);
+
+    PropagationFunction() = default;
+    PropagationFunction(const PropagationFunction&) = delete;
+    PropagationFunction& operator=(const PropagationFunction&) = delete;
+    ~PropagationFunction() { reset(); }
+
+    template <typename F>
+    void assign(F&& function) {
+        using Fn = std::decay_t<F>;
+        static_assert(std::is_convertible<std::invoke_result_t<Fn&>, VSRTL_VT_U>::value,
+                      "Propagation functions must return a value convertible to VSRTL_VT_U");
+        emplace<Fn>(std::forward<F>(function), &s_inlineOps<Fn>, &s_heapOps<Fn>);
+    }
+
+    template <unsigned int W, typename F>
+    void assignWide(F&& function) {
+        using Fn = std::decay_t<F>;
+        static_assert(std::is_convertible<std::invoke_result_t<Fn&>, WideValue<W>>::value,
+                      "Propagation functions of wide ports must return a value convertible to WideValue<W>");
+        emplace<Fn>(std::forward<F>(function), &s_inlineWideOps<Fn, W>, &s_heapWideOps<Fn, W>);
+    }
+
+    void reset() {
+        if (m_ops && m_ops->destroy) {
+            m_ops->destroy(&m_storage);
+        }
+        m_ops = nullptr;
+    }
+
+    explicit operator bool() const { return m_ops != nullptr; }
+    VSRTL_VT_U operator()() const { return m_ops->invoke(&m_storage); }
+
+    /**
+     * @brief invoker, closure
+     * Allows callers (ie. the propagation schedule) to cache the trampoline and closure pointers, such that
+     * invoking the function is a single indirect call.
+     */
+    Invoker invoker() const { return m_ops ? m_ops->invoke : nullptr; }
+    WideInvoker wideInvoker() const { return m_ops ? m_ops->invokeWide : nullptr; }
+    const void* closure() const { return &m_storage; }
+
+    bool evaluateWide(VSRTL_VT_U* dst) const { return m_ops->invokeWide(&m_storage, dst); }
+
+private:
+    static constexpr std::size_t s_inlineSize = 2 * sizeof(void*);
+
+    struct Ops {
+        Invoker invoke;
+        WideInvoker invokeWide;
+        void (*destroy)(void*);
+    };
+
+    template <typename Fn, typename F>
+    void emplace(F&& function, const Ops* inlineOps, const Ops* heapOps) {
+        reset();
+        if constexpr (storedInline<Fn>()) {
+            new (&m_storage) Fn(std::forward<F>(function));
+            m_ops = inlineOps;
+        } else {
+            *reinterpret_cast<Fn**>(&m_storage) = new Fn(std::forward<F>(function));
+            m_ops = heapOps;
+        }
+    }
+
+    template <typename Fn>
+    static constexpr bool storedInline() {
+        return sizeof(Fn) <= s_inlineSize && alignof(Fn) <= alignof(void*) &&
+               std::is_nothrow_move_constructible<Fn>::value;
+    }
+
+    template <typename Fn>
+    static VSRTL_VT_U invokeInline(const void* storage) {
+        return static_cast<VSRTL_VT_U>((*static_cast<Fn*>(const_cast<void*>(storage)))());
+    }
+    template <typename Fn>
+    static void destroyInline(void* storage) {
+        static_cast<Fn*>(storage)->~Fn();
+    }
+    template <typename Fn>
+    static VSRTL_VT_U invokeHeap(const void* storage) {
+        return static_cast<VSRTL_VT_U>((**static_cast<Fn* const*>(storage))());
+    }
+    template <typename Fn, unsigned int W>
+    static bool invokeWideInline(const void* storage, VSRTL_VT_U* dst) {
+        return WideValue<W>((*static_cast<Fn*>(const_cast<void*>(storage)))()).store(dst);
+    }
+    template <typename Fn, unsigned int W>
+    static bool invokeWideHeap(const void* storage, VSRTL_VT_U* dst) {
+        return WideValue<W>((**static_cast<Fn* const*>(storage))()).store(dst);
+    }
+    template <typename Fn>
+    static void destroyHeap(void* storage) {
+        delete *static_cast<Fn**>(storage);
+    }
+
+    template <typename Fn>
+    static constexpr Ops s_inlineOps = {&invokeInline<Fn>, nullptr,
+                                        std::is_trivially_destructible<Fn>::value ? nullptr : &destroyInline<Fn>};
+    template <typename Fn>
+    static constexpr Ops s_heapOps = {&invokeHeap<Fn>, nullptr, &destroyHeap<Fn>};
+    template <typename Fn, unsigned int W>
+    static constexpr Ops s_inlineWideOps = {
+        nullptr, &invokeWideInline<Fn, W>, std::is_trivially_destructible<Fn>::value ? nullptr : &destroyInline<Fn>};
+    template <typename Fn, unsigned int W>
+    static constexpr Ops s_heapWideOps = {nullptr, &invokeWideHeap<Fn, W>, &destroyHeap<Fn>};
+
+    alignas(void*) unsigned char m_storage[s_inlineSize];
+    const Ops* m_ops = nullptr;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_PROPAGATIONFUNCTION_H
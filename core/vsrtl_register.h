@@ -3,10 +3,13 @@
 
 #include "../interface/vsrtl_binutils.h"
 #include "vsrtl_component.h"
+#include "vsrtl_journal.h"
 #include "vsrtl_port.h"
+#include "vsrtl_registerbank.h"
+#include "vsrtl_state.h"
 
 #include <algorithm>
-#include <deque>
+#include <typeinfo>
 #include <vector>
 
 /** Registered input
@@ -46,10 +49,37 @@ public:
     ClockedComponent(std::string name, SimComponent* parent) : Component(name, parent), SimSynchronous(this) {}
     virtual void save() = 0;
 
-    static unsigned int& reverseStackSize() {
-        static unsigned int s_reverseStackSize = 100;
-        return s_reverseStackSize;
+    /**
+     * @brief saveState, restoreState
+     * Append the clocked state of the component to @p state, respectively restore it from @p state. Reverse execution
+     * of a design restores checkpoints of this state, and thus requires all clocked components to implement these.
+     */
+    virtual void saveState(std::vector<VSRTL_VT_U>& /* state */) const {
+        throwError("Component does not support saving its state");
     }
+    virtual void restoreState(StateReader& /* state */) { throwError("Component does not support restoring its state"); }
+
+    /**
+     * @brief journalsState
+     * Components journaling their state record the state which save() overwrites in the journal of the design (if
+     * recording), and restore it through revert(). A design only reverses through its journal if all of its clocked
+     * components journal their state.
+     */
+    virtual bool journalsState() const { return false; }
+    virtual void revert(StateReader& /* delta */) { throwError("Component does not journal its state"); }
+
+    void setJournal(StateJournal* journal, unsigned index) {
+        m_journal = journal;
+        m_journalIndex = index;
+    }
+
+protected:
+    StateJournal* journal() const { return m_journal && m_journal->recording() ? m_journal : nullptr; }
+    unsigned journalIndex() const { return m_journalIndex; }
+
+private:
+    StateJournal* m_journal = nullptr;
+    unsigned m_journalIndex = 0;
 };
 
 class RegisterBase : public ClockedComponent {
@@ -58,63 +88,85 @@ public:
 
     virtual PortBase* getIn() = 0;
     virtual PortBase* getOut() = 0;
+
+    /**
+     * @brief bindToBank
+     * Moves the state of the register into @p bank, such that the register is clocked by the bank rather than through
+     * save().
+     * @returns false if the register cannot be clocked by a register bank
+     */
+    virtual bool bindToBank(RegisterBank& /* bank */) { return false; }
 };
 
 template <unsigned int W>
 class Register : public RegisterBase {
 public:
     SetGraphicsType(Register);
+    // Wide registers hold their state as a multi-limb value
+    using value_type = std::conditional_t<isWideWidth(W), WideValue<W>, VSRTL_VT_U>;
 
     Register(std::string name, SimComponent* parent) : RegisterBase(name, parent) {
         setSpecialPort("in", getIn());
         setSpecialPort("out", getOut());
 
         // Calling out.propagate() will clock the register the register
-        out << ([=] { return m_savedValue; });
+        out << ([=] { return *m_state; });
     }
 
     void setInitValue(VSRTL_VT_U value) { m_initvalue = value; }
 
-    void reset() override {
-        m_savedValue = m_initvalue;
-        m_reverseStack.clear();
-    }
+    void reset() override { *m_state = m_initvalue; }
 
-    void save() override {
-        saveToStack();
-        m_savedValue = in.template value<VSRTL_VT_U>();
-    }
+    void save() override { commit(in.template value<value_type>()); }
 
     void forceValue(VSRTL_VT_U /* addr */, VSRTL_VT_U value) override {
-        // Sign-extension with unsigned type forces width truncation to m_width bits
-        m_savedValue = signextend<VSRTL_VT_U, W>(value);
-        // Forced values are a modification of the current state and thus not pushed onto the reverse stack
-    }
-
-    void reverse() override {
-        if (m_reverseStack.size() > 0) {
-            m_savedValue = m_reverseStack.front();
-            m_reverseStack.pop_front();
+        if constexpr (isWideWidth(W)) {
+            *m_state = value;
+        } else {
+            // Sign-extension with unsigned type forces width truncation to m_width bits
+            *m_state = signextend<VSRTL_VT_U, W>(value);
         }
     }
 
+    void saveState(std::vector<VSRTL_VT_U>& state) const override { saveValue(state, *m_state); }
+    void restoreState(StateReader& state) override { restoreValue(state, *m_state); }
+
+    bool journalsState() const override { return true; }
+    void revert(StateReader& delta) override { restoreValue(delta, *m_state); }
+
     PortBase* getIn() override { return &in; }
     PortBase* getOut() override { return &out; }
 
+    /**
+     * Registers overriding save() are not clocked by a register bank, since the bank does not call save().
+     */
+    bool bindToBank(RegisterBank& bank) override {
+        if constexpr (isWideWidth(W)) {
+            return false;
+        } else {
+            if (typeid(*this) != typeid(Register<W>))
+                return false;
+            bank.add(&in, nullptr, nullptr, journalIndex(), m_state);
+            return true;
+        }
+    }
+
     INPUTPORT(in, W);
     OUTPUTPORT(out, W);
 
 protected:
-    void saveToStack() {
-        m_reverseStack.push_front(m_savedValue);
-        if (m_reverseStack.size() > reverseStackSize()) {
-            m_reverseStack.pop_back();
-        }
+    void commit(const value_type& value) {
+        if (value == *m_state)
+            return;
+        if (auto* j = journal())
+            j->recordValue(journalIndex(), *m_state);
+        *m_state = value;
     }
 
-    VSRTL_VT_U m_savedValue = 0;
-    VSRTL_VT_U m_initvalue = 0;
-    std::deque<VSRTL_VT_U> m_reverseStack;
+    value_type m_savedValue = 0;
+    value_type m_initvalue = 0;
+    // The state of the register; m_savedValue, unless the register is bound to a register bank
+    value_type* m_state = &m_savedValue;
 };
 
 // Synchronous clear/enable register
@@ -124,16 +176,26 @@ public:
     RegisterClEn(std::string name, SimComponent* parent) : Register<W>(name, parent) {}
 
     void save() override {
-        this->saveToStack();
         if (enable.uValue()) {
             if (clear.uValue()) {
-                this->m_savedValue = 0;
+                this->commit(0);
             } else {
-                this->m_savedValue = this->in.template value<VSRTL_VT_U>();
+                this->commit(this->in.template value<typename Register<W>::value_type>());
             }
         }
     }
 
+    bool bindToBank(RegisterBank& bank) override {
+        if constexpr (isWideWidth(W)) {
+            return false;
+        } else {
+            if (typeid(*this) != typeid(RegisterClEn<W>))
+                return false;
+            bank.add(&this->in, &enable, &clear, this->journalIndex(), this->m_state);
+            return true;
+        }
+    }
+
     INPUTPORT(enable, 1);
     INPUTPORT(clear, 1);
 };
@@ -142,6 +204,7 @@ template <unsigned int W>
 class ShiftRegister : public RegisterBase {
 public:
     SetGraphicsType(Register);
+    using value_type = std::conditional_t<isWideWidth(W), WideValue<W>, VSRTL_VT_U>;
 
     ShiftRegister(std::string name, SimComponent* parent) : RegisterBase(name, parent) {
         setSpecialPort("in", getIn());
@@ -163,32 +226,39 @@ public:
         for (int i = 0; i < m_savedValues.size(); i++) {
             m_savedValues[i] = m_initvalue;
         }
-        m_reverseStack.clear();
     }
 
     void save() override {
-        m_reverseStack.push_front(m_savedValues.at(stages.getValue() - 1));
-        if (m_reverseStack.size() > reverseStackSize()) {
-            m_reverseStack.pop_back();
-        }
+        if (auto* j = journal())
+            j->recordValue(journalIndex(), m_savedValues.back());
         // Rotate to the right and store new value as first register
         std::rotate(m_savedValues.rbegin(), m_savedValues.rbegin() + 1, m_savedValues.rend());
-        m_savedValues.at(0) = in.template value<VSRTL_VT_U>();
+        m_savedValues.at(0) = in.template value<value_type>();
     }
 
     void forceValue(VSRTL_VT_U /* addr */, VSRTL_VT_U value) override {
-        // Sign-extension with unsigned type forces width truncation to m_width bits
-        m_savedValues[0] = signextend<VSRTL_VT_U, W>(value);
-        // Forced values are a modification of the current state and thus not pushed onto the reverse stack
+        if constexpr (isWideWidth(W)) {
+            m_savedValues[0] = value;
+        } else {
+            // Sign-extension with unsigned type forces width truncation to m_width bits
+            m_savedValues[0] = signextend<VSRTL_VT_U, W>(value);
+        }
     }
 
-    void reverse() override {
-        if (m_reverseStack.size() > 0) {
-            // Rotate to the left and store popped value as last register
-            std::rotate(m_savedValues.begin(), m_savedValues.begin() + 1, m_savedValues.end());
-            m_savedValues.at(stages.getValue() - 1) = m_reverseStack.front();
-            m_reverseStack.pop_front();
-        }
+    void saveState(std::vector<VSRTL_VT_U>& state) const override {
+        for (const auto& v : m_savedValues)
+            saveValue(state, v);
+    }
+    void restoreState(StateReader& state) override {
+        for (auto& v : m_savedValues)
+            restoreValue(state, v);
+    }
+
+    bool journalsState() const override { return true; }
+    void revert(StateReader& delta) override {
+        // Rotate to the left and restore the value which was shifted out
+        std::rotate(m_savedValues.begin(), m_savedValues.begin() + 1, m_savedValues.end());
+        restoreValue(delta, m_savedValues.back());
     }
 
     PortBase* getIn() override { return &in; }
@@ -201,9 +271,8 @@ public:
 protected:
     void stagesChanged() { m_savedValues.resize(stages.getValue()); }
 
-    std::vector<VSRTL_VT_U> m_savedValues;
-    VSRTL_VT_U m_initvalue = 0;
-    std::deque<VSRTL_VT_U> m_reverseStack;
+    std::vector<value_type> m_savedValues;
+    value_type m_initvalue = 0;
 };
 
 }  // namespace core
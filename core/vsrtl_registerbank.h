@@ -0,0 +1,102 @@
+#ifndef VSRTL_REGISTERBANK_H
+#define VSRTL_REGISTERBANK_H
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+#include "vsrtl_defines.h"
+#include "vsrtl_journal.h"
+#include "vsrtl_port.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The RegisterBank class
+ * Contiguous storage of the state of narrow registers. Each register refers to its slot of the bank instead of holding
+ * its own state. The bank is held as parallel arrays, such that clocking all registers is a gather of their inputs
+ * into a next-state array, followed by a branch-free selection of the next state (masked by the enable and clear
+ * inputs of clear/enable registers) and a bulk commit of the next state into the current state array.
+ * Registers are clocked in the order in which they were added.
+ */
+class RegisterBank {
+public:
+    /**
+     * @brief add
+     * Adds a register whose next state is the value of @p in. Registers without an enable (or clear) input pass
+     * nullptr for @p enable (@p clear). The current state of the register, referred to by @p state, is moved into the
+     * bank; @p state is updated to refer to the bank for as long as the bank exists.
+     */
+    void add(const PortBase* in, const PortBase* enable, const PortBase* clear, unsigned journalIndex,
+             VSRTL_VT_U*& state) {
+        const VSRTL_VT_U* storage = m_current.data();
+        m_inputs.push_back(in->m_slot);
+        m_enables.push_back(enable ? enable->m_slot : &s_one);
+        m_clears.push_back(clear ? clear->m_slot : &s_zero);
+        m_masks.push_back(valueMask(in->getWidth()));
+        m_journalIndices.push_back(journalIndex);
+        m_current.push_back(*state);
+        m_next.push_back(*state);
+        m_owners.push_back(&state);
+
+        if (m_current.data() != storage) {
+            // The state array was reallocated
+            for (unsigned i = 0; i < m_owners.size(); i++)
+                *m_owners[i] = &m_current[i];
+        } else {
+            state = &m_current.back();
+        }
+    }
+
+    /**
+     * @brief clock
+     * Clocks all registers of the bank. If @p journal is set, the previous state of each register which changes is
+     * recorded in the journal.
+     */
+    void clock(StateJournal* journal) {
+        const unsigned n = m_current.size();
+        VSRTL_VT_U* next = m_next.data();
+        const VSRTL_VT_U* current = m_current.data();
+        for (unsigned i = 0; i < n; i++)
+            next[i] = *m_inputs[i];
+        for (unsigned i = 0; i < n; i++) {
+            const VSRTL_VT_U enable = -(*m_enables[i] & 1);
+            const VSRTL_VT_U clear = -(*m_clears[i] & 1);
+            next[i] = (next[i] & m_masks[i] & ~clear & enable) | (current[i] & ~enable);
+        }
+
+        if (journal) {
+            for (unsigned i = 0; i < n; i++) {
+                if (next[i] != current[i])
+                    journal->recordValue(m_journalIndices[i], current[i]);
+            }
+        }
+        std::copy(m_next.begin(), m_next.end(), m_current.begin());
+    }
+
+    unsigned size() const { return m_current.size(); }
+
+private:
+    static VSRTL_VT_U valueMask(unsigned width) {
+        return width >= sizeof(VSRTL_VT_U) * CHAR_BIT ? ~VSRTL_VT_U(0) : (VSRTL_VT_U(1) << width) - 1;
+    }
+
+    static constexpr VSRTL_VT_U s_one = 1;
+    static constexpr VSRTL_VT_U s_zero = 0;
+
+    std::vector<const VSRTL_VT_U*> m_inputs;
+    std::vector<const VSRTL_VT_U*> m_enables;
+    std::vector<const VSRTL_VT_U*> m_clears;
+    std::vector<VSRTL_VT_U> m_masks;
+    std::vector<unsigned> m_journalIndices;
+    std::vector<VSRTL_VT_U> m_current;
+    std::vector<VSRTL_VT_U> m_next;
+    // The state pointers of the registers of the bank
+    std::vector<VSRTL_VT_U**> m_owners;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_REGISTERBANK_H
@@ -0,0 +1,649 @@
+#ifndef VSRTL_SCHEDULE_H
+#define VSRTL_SCHEDULE_H
+
+#include <limits.h>
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "vsrtl_component.h"
+#include "vsrtl_defines.h"
+#include "vsrtl_port.h"
+#include "vsrtl_propagationfunction.h"
+#include "vsrtl_threadpool.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The PropagationMode enum
+ * full:        Every port in the propagation schedule is re-evaluated upon propagating the design.
+ * eventDriven: Only the transitive fan-out of ports whose values changed are re-evaluated. Evaluation starts from the
+ *              outputs of state-dependent components (registers, memories), and proceeds in levelized order.
+ * parallel:    Every port is re-evaluated, level by level, with the ports of each level distributed across a pool of
+ *              worker threads.
+ */
+enum class PropagationMode { full, eventDriven, parallel };
+
+/**
+ * @brief The PropagationSchedule class
+ * A flattened, index-based representation of a design's propagation stack. When compiled, all port values of the
+ * design are gathered into a single contiguous array, and each port in the propagation stack is lowered to an
+ * operation which reads and writes value slots by index. Propagating the design is then a linear sweep over the
+ * operation list, without virtual dispatch or pointer chasing through the port graph.
+ */
+class PropagationSchedule {
+public:
+    struct Operation {
+        // Propagation function of the port, invoked as function(closure). Wide ports are evaluated through
+        // wideFunction(closure, &values[dst]) instead, and have a null function.
+        PropagationFunction::Invoker function;
+        PropagationFunction::WideInvoker wideFunction;
+        const void* closure;
+        unsigned dst;
+        // Truncation mask applied to the computed value, equivalent to reading a W-bit port as an unsigned value
+        VSRTL_VT_U mask;
+        PortBase* port;
+    };
+
+    struct BitOperand {
+        unsigned slot;
+        unsigned bit;
+    };
+
+    struct BitwiseGroup {
+        BitwiseFunction::Operator op;
+        unsigned nOperands;
+        unsigned level;
+        unsigned begin, end;
+        // Offset of the group's operands in m_bitwiseOperands
+        unsigned operands;
+    };
+
+    /**
+     * @brief compile
+     * Lowers @p propagationStack into the operation list. @p ports must contain every port of the design; each port
+     * is relocated to a slot in the port value array. Ports in the propagation stack are assigned slots first, in
+     * propagation order.
+     * Pass-through ports (ports without a propagation function, which solely forward the value of their input port,
+     * such as ports on hierarchy boundaries) are aliased to the slot of the port which drives them, and are thus not
+     * part of the operation list.
+     */
+    void compile(const std::vector<PortBase*>& propagationStack, const std::vector<PortBase*>& ports) {
+        m_allOperations.clear();
+        m_ports = ports;
+        m_slots.clear();
+        m_values.clear();
+        unsigned nSlots = 0;
+        for (const auto& p : ports) {
+            if (!isPassThrough(p))
+                nSlots += p->getLimbCount();
+        }
+        m_values.resize(nSlots);
+        m_nextSlot = 0;
+
+        for (const auto& p : propagationStack)
+            assignSlot(p);
+        for (const auto& p : ports)
+            assignSlot(p);
+        compileAliases(ports);
+
+        for (const auto& p : propagationStack) {
+            if (isPassThrough(p))
+                continue;
+            Operation op;
+            op.function = p->m_propagationFunction.invoker();
+            op.wideFunction = p->m_propagationFunction.wideInvoker();
+            op.closure = p->m_propagationFunction.closure();
+            op.dst = m_slots.at(p);
+            op.mask = valueMask(p->getWidth());
+            op.port = p;
+            m_allOperations.push_back(op);
+        }
+        m_compiled = true;
+        selectOperations();
+    }
+
+    /**
+     * @brief setPruning
+     * Enables pruning of operations which can neither affect the state of the design (the inputs of synchronous
+     * components) nor the value of any port in @p observed. Pruned ports are excluded from propagation until they are
+     * observed.
+     */
+    void setPruning(bool enabled, const std::set<const PortBase*>& observed) {
+        m_pruning = enabled;
+        m_observed = observed;
+        if (m_compiled)
+            selectOperations();
+    }
+
+    bool isCompiled() const { return m_compiled; }
+
+    /**
+     * @brief propagate
+     * Evaluates every operation of the schedule. If bit packing is enabled, and the schedule contains bitwise
+     * operations, the schedule is evaluated level by level, evaluating the bitwise operations of each level in packed
+     * groups.
+     */
+    void propagate(bool emitSignals) {
+        if (m_bitPacking && !m_bitwiseGroups.empty()) {
+            propagatePacked(emitSignals);
+            return;
+        }
+        for (const auto& op : m_operations)
+            evaluate(op, emitSignals);
+    }
+
+    /**
+     * @brief setBitPacking
+     * Enables bit-packed evaluation of single-bit operations which their components describe as bitwise functions
+     * (see Component::getBitwiseFunction()). Operations of the same operator, operand count and level are evaluated
+     * 64 at a time, computing their results and detecting changes with a single word-wide instruction per operand,
+     * rather than invoking the propagation function of each port. Only applies to PropagationMode::full.
+     */
+    void setBitPacking(bool enabled) { m_bitPacking = enabled; }
+    bool bitPacking() const { return m_bitPacking; }
+
+    /**
+     * @brief propagateChanges
+     * Evaluates the source operations of the schedule, and thereafter only operations which read a value that changed
+     * during this propagation. Operations are evaluated level by level, ensuring that each operation is evaluated at
+     * most once, after all of its dependencies.
+     */
+    void propagateChanges(bool emitSignals) {
+        for (const auto& idx : m_sourceOperations)
+            enqueue(idx);
+
+        for (auto& bucket : m_levelBuckets) {
+            // Operations only enqueue operations of a strictly higher level, so the bucket is stable while iterating
+            for (const auto& idx : bucket) {
+                m_enqueued[idx] = false;
+                const auto& op = m_operations[idx];
+                if (evaluate(op, emitSignals)) {
+                    for (unsigned i = m_fanoutOffsets[op.dst]; i < m_fanoutOffsets[op.dst + 1]; i++)
+                        enqueue(m_fanout[i]);
+                }
+            }
+            bucket.clear();
+        }
+    }
+
+    /**
+     * @brief propagateParallel
+     * Evaluates every operation of the schedule, level by level. Operations within a level are independent of each
+     * other, and levels with at least @p grainSize operations are evaluated in chunks of @p grainSize operations
+     * across the threads of @p pool. Change signals are emitted from the calling thread once all levels have been
+     * evaluated.
+     */
+    void propagateParallel(ThreadPool& pool, unsigned grainSize, bool emitSignals) {
+        for (unsigned level = 0; level + 1 < m_levelOffsets.size(); level++) {
+            const unsigned begin = m_levelOffsets[level];
+            const unsigned end = m_levelOffsets[level + 1];
+            if (end - begin < 2 * grainSize || pool.threadCount() == 1) {
+                for (unsigned i = begin; i < end; i++)
+                    m_changed[m_levelOrder[i]] = evaluate(m_operations[m_levelOrder[i]], false);
+            } else {
+                const unsigned nChunks = (end - begin + grainSize - 1) / grainSize;
+                pool.run(nChunks, [&](unsigned chunk) {
+                    const unsigned chunkEnd = std::min(end, begin + (chunk + 1) * grainSize);
+                    for (unsigned i = begin + chunk * grainSize; i < chunkEnd; i++)
+                        m_changed[m_levelOrder[i]] = evaluate(m_operations[m_levelOrder[i]], false);
+                });
+            }
+        }
+
+        if (emitSignals) {
+            for (unsigned idx = 0; idx < m_operations.size(); idx++) {
+                if (m_changed[idx])
+                    emitChanged(m_operations[idx]);
+            }
+        }
+    }
+
+    /**
+     * @brief emitAllChanged
+     * Emits the change signal of all ports which are driven by an operation, ie. after the value array has been
+     * replaced externally.
+     */
+    void emitAllChanged() {
+        for (const auto& op : m_operations)
+            emitChanged(op);
+    }
+
+    /**
+     * @brief emitChangedSince
+     * Emits the change signal of all ports driven by an operation whose value differs from @p previous, a copy of the
+     * value array taken prior to replacing it externally.
+     */
+    void emitChangedSince(const std::vector<VSRTL_VT_U>& previous) {
+        for (const auto& op : m_operations) {
+            const unsigned limbs = op.port->getLimbCount();
+            if (!std::equal(previous.begin() + op.dst, previous.begin() + op.dst + limbs, m_values.begin() + op.dst))
+                emitChanged(op);
+        }
+    }
+
+    /**
+     * @brief setBatchedNotification
+     * When enabled, change signals are not emitted during propagation. Instead, changed ports are recorded in a
+     * change set, which is retrieved through takeChanges().
+     */
+    void setBatchedNotification(bool enabled) { m_batchedNotification = enabled; }
+    bool batchedNotification() const { return m_batchedNotification; }
+
+    /**
+     * @brief takeChanges
+     * Appends all ports which changed since the last call to @p ports, including the pass-through ports aliasing
+     * them, and clears the change set. Each port is reported once.
+     */
+    void takeChanges(std::vector<PortBase*>& ports) {
+        for (const auto& change : m_dirty) {
+            change.first->m_dirty = false;
+            ports.push_back(change.first);
+            for (unsigned i = m_aliasOffsets[change.second]; i < m_aliasOffsets[change.second + 1]; i++)
+                ports.push_back(m_aliases[i]);
+        }
+        m_dirty.clear();
+    }
+
+    unsigned slotOf(const PortBase* port) const { return m_slots.at(port); }
+    const std::vector<Operation>& getOperations() const { return m_operations; }
+    std::vector<VSRTL_VT_U>& getValues() { return m_values; }
+    const std::vector<VSRTL_VT_U>& getValues() const { return m_values; }
+
+private:
+    static VSRTL_VT_U valueMask(unsigned width) {
+        return width >= sizeof(VSRTL_VT_U) * CHAR_BIT ? ~VSRTL_VT_U(0) : (VSRTL_VT_U(1) << width) - 1;
+    }
+
+    static bool isPassThrough(const PortBase* port) {
+        return !port->m_propagationFunction && port->m_inputPort != nullptr;
+    }
+
+    void assignSlot(PortBase* port) {
+        if (isPassThrough(port) || m_slots.count(port) != 0)
+            return;
+        const unsigned slot = m_nextSlot;
+        m_nextSlot += port->getLimbCount();
+        m_slots[port] = slot;
+        port->relocate(&m_values.at(slot));
+    }
+
+    /**
+     * @brief compileAliases
+     * Points each pass-through port to the slot of the root port which drives it, and records the aliases of each
+     * slot, such that change signals may be emitted for all ports sharing a slot.
+     */
+    void compileAliases(const std::vector<PortBase*>& ports) {
+        std::vector<std::vector<PortBase*>> aliases(m_values.size());
+        for (const auto& p : ports) {
+            if (!isPassThrough(p))
+                continue;
+            PortBase* root = p;
+            while (isPassThrough(root))
+                root = root->getInputPort<PortBase>();
+            const unsigned slot = m_slots.at(root);
+            m_slots[p] = slot;
+            p->m_slot = root->m_slot;
+            aliases[slot].push_back(p);
+        }
+
+        m_aliasOffsets.assign(m_values.size() + 1, 0);
+        m_aliases.clear();
+        for (unsigned slot = 0; slot < aliases.size(); slot++) {
+            m_aliases.insert(m_aliases.end(), aliases[slot].begin(), aliases[slot].end());
+            m_aliasOffsets[slot + 1] = m_aliases.size();
+        }
+    }
+
+    /**
+     * @brief selectOperations
+     * Selects the operations to be propagated from the compiled operation list, pruning dead logic if enabled, and
+     * (re)builds the dependency and bitwise tables for the selection.
+     */
+    void selectOperations() {
+        for (const auto& op : m_allOperations)
+            setPruned(op, false);
+
+        if (!m_pruning) {
+            m_operations = m_allOperations;
+        } else {
+            std::vector<bool> live(m_values.size(), false);
+            for (const auto& port : m_observed)
+                live[m_slots.at(port)] = true;
+            // Synchronous components read their inputs when clocked
+            std::set<Component*> synchronous;
+            for (const auto& port : m_ports) {
+                auto* parent = port->getParent<Component>();
+                if (parent->isSynchronous())
+                    synchronous.insert(parent);
+            }
+            for (const auto& c : synchronous) {
+                for (const auto& in : c->getPorts<SimPort::Direction::in, PortBase>())
+                    live[m_slots.at(in)] = true;
+                for (const auto& sens : c->getSensitivityList())
+                    live[m_slots.at(sens)] = true;
+            }
+
+            // Operations are topologically ordered; a reverse sweep marks the transitive fan-in of all live slots
+            std::vector<bool> liveOperation(m_allOperations.size(), false);
+            for (unsigned idx = m_allOperations.size(); idx-- > 0;) {
+                const auto& op = m_allOperations[idx];
+                if (!live[op.dst])
+                    continue;
+                liveOperation[idx] = true;
+                for (const auto& slot : readSlots(op))
+                    live[slot] = true;
+            }
+
+            m_operations.clear();
+            for (unsigned idx = 0; idx < m_allOperations.size(); idx++) {
+                if (liveOperation[idx])
+                    m_operations.push_back(m_allOperations[idx]);
+                else
+                    setPruned(m_allOperations[idx], true);
+            }
+        }
+        compileDependencies();
+        compileBitwise();
+    }
+
+    void setPruned(const Operation& op, bool pruned) {
+        op.port->m_pruned = pruned;
+        for (unsigned i = m_aliasOffsets[op.dst]; i < m_aliasOffsets[op.dst + 1]; i++)
+            m_aliases[i]->m_pruned = pruned;
+    }
+
+    /**
+     * @brief readSlots
+     * @returns the value slots which the propagation function of @p op may read; the input ports and sensitivity list
+     * of its parent component. Outputs of synchronous components are a function of the component's state alone.
+     */
+    std::vector<unsigned> readSlots(const Operation& op) const {
+        std::vector<unsigned> reads;
+        auto* parent = op.port->getParent<Component>();
+        if (parent->isSynchronous())
+            return reads;
+        for (const auto& in : parent->getPorts<SimPort::Direction::in, PortBase>())
+            reads.push_back(m_slots.at(in));
+        for (const auto& sens : parent->getSensitivityList())
+            reads.push_back(m_slots.at(sens));
+        return reads;
+    }
+
+    /**
+     * @brief evaluate
+     * @return true if the value of the operation's destination slot changed
+     */
+    inline bool evaluate(const Operation& op, bool emitSignals) {
+        if (!op.function) {
+            if (!op.wideFunction(op.closure, &m_values[op.dst]))
+                return false;
+            if (emitSignals) {
+                emitChanged(op);
+            }
+            return true;
+        }
+        const VSRTL_VT_U value = op.function(op.closure) & op.mask;
+        if (m_values[op.dst] != value) {
+            m_values[op.dst] = value;
+            if (emitSignals) {
+                emitChanged(op);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void emitChanged(const Operation& op) {
+        if (m_batchedNotification) {
+            if (!op.port->m_dirty) {
+                op.port->m_dirty = true;
+                m_dirty.push_back({op.port, op.dst});
+            }
+            return;
+        }
+        op.port->changed.Emit();
+        for (unsigned i = m_aliasOffsets[op.dst]; i < m_aliasOffsets[op.dst + 1]; i++)
+            m_aliases[i]->changed.Emit();
+    }
+
+    /**
+     * @brief propagatePacked
+     * Full propagation in levelized order, with the scalar operations of each level evaluated before its bitwise
+     * groups.
+     */
+    void propagatePacked(bool emitSignals) {
+        unsigned group = 0;
+        for (unsigned level = 0; level + 1 < m_scalarLevelOffsets.size(); level++) {
+            for (unsigned i = m_scalarLevelOffsets[level]; i < m_scalarLevelOffsets[level + 1]; i++)
+                evaluate(m_operations[m_scalarOrder[i]], emitSignals);
+            for (; group < m_bitwiseGroups.size() && m_bitwiseGroups[group].level == level; group++)
+                evaluateBitwise(m_bitwiseGroups[group], emitSignals);
+        }
+    }
+
+    inline uint64_t gatherBits(const BitOperand* operands, unsigned stride, unsigned n) const {
+        uint64_t word = 0;
+        for (unsigned j = 0; j < n; j++)
+            word |= static_cast<uint64_t>((m_values[operands[j * stride].slot] >> operands[j * stride].bit) & 1) << j;
+        return word;
+    }
+
+    void evaluateBitwise(const BitwiseGroup& group, bool emitSignals) {
+        const unsigned stride = group.nOperands;
+        for (unsigned base = group.begin; base < group.end; base += 64) {
+            const unsigned n = std::min(group.end - base, 64u);
+            const BitOperand* operands = &m_bitwiseOperands[group.operands + (base - group.begin) * stride];
+
+            uint64_t result = gatherBits(operands, stride, n);
+            for (unsigned k = 1; k < stride; k++) {
+                const uint64_t word = gatherBits(operands + k, stride, n);
+                switch (group.op) {
+                    case BitwiseFunction::Operator::And:
+                        result &= word;
+                        break;
+                    case BitwiseFunction::Operator::Or:
+                        result |= word;
+                        break;
+                    case BitwiseFunction::Operator::Xor:
+                        result ^= word;
+                        break;
+                }
+            }
+
+            // Slots holding anything but a single bit (ie. prior to the first propagation) are always rewritten
+            uint64_t previous = 0, invalid = 0;
+            for (unsigned j = 0; j < n; j++) {
+                const VSRTL_VT_U value = m_values[m_bitwiseDst[base + j]];
+                previous |= static_cast<uint64_t>(value & 1) << j;
+                invalid |= static_cast<uint64_t>(value > 1) << j;
+            }
+
+            uint64_t changed = (result ^ previous) | invalid;
+            for (unsigned j = 0; changed != 0; j++, changed >>= 1) {
+                if (changed & 1) {
+                    m_values[m_bitwiseDst[base + j]] = (result >> j) & 1;
+                    if (emitSignals)
+                        emitChanged(m_operations[m_bitwiseOperations[base + j]]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief compileBitwise
+     * Groups single-bit operations described as bitwise functions by level, operator and operand count. Operand
+     * descriptors are stored operation-major, such that each group occupies a contiguous range.
+     */
+    void compileBitwise() {
+        using GroupKey = std::tuple<unsigned, BitwiseFunction::Operator, unsigned>;
+        std::map<GroupKey, std::vector<unsigned>> groups;
+        std::vector<std::vector<BitOperand>> operands(m_operations.size());
+
+        for (unsigned idx = 0; idx < m_operations.size(); idx++) {
+            const auto& op = m_operations[idx];
+            if (op.mask != 1)
+                continue;
+            BitwiseFunction function;
+            if (!op.port->getParent<Component>()->getBitwiseFunction(op.port, function) || function.operands.empty())
+                continue;
+            for (const auto& operand : function.operands) {
+                // Bits of wide operands are located in the limb holding the bit
+                operands[idx].push_back({m_slots.at(operand.first) + operand.second / valueBits(),
+                                         operand.second % valueBits()});
+            }
+            groups[{m_levels[idx], function.op, function.operands.size()}].push_back(idx);
+        }
+
+        m_bitwiseGroups.clear();
+        m_bitwiseOperations.clear();
+        m_bitwiseDst.clear();
+        m_bitwiseOperands.clear();
+        std::vector<bool> packed(m_operations.size(), false);
+        for (const auto& group : groups) {
+            BitwiseGroup g;
+            g.level = std::get<0>(group.first);
+            g.op = std::get<1>(group.first);
+            g.nOperands = std::get<2>(group.first);
+            g.begin = m_bitwiseOperations.size();
+            g.operands = m_bitwiseOperands.size();
+            for (const auto& idx : group.second) {
+                packed[idx] = true;
+                m_bitwiseOperations.push_back(idx);
+                m_bitwiseDst.push_back(m_operations[idx].dst);
+                m_bitwiseOperands.insert(m_bitwiseOperands.end(), operands[idx].begin(), operands[idx].end());
+            }
+            g.end = m_bitwiseOperations.size();
+            m_bitwiseGroups.push_back(g);
+        }
+
+        // Remaining operations, in level order
+        m_scalarOrder.clear();
+        m_scalarLevelOffsets.assign(m_levelOffsets.size(), 0);
+        for (unsigned level = 0; level + 1 < m_levelOffsets.size(); level++) {
+            for (unsigned i = m_levelOffsets[level]; i < m_levelOffsets[level + 1]; i++) {
+                if (!packed[m_levelOrder[i]])
+                    m_scalarOrder.push_back(m_levelOrder[i]);
+            }
+            m_scalarLevelOffsets[level + 1] = m_scalarOrder.size();
+        }
+    }
+
+    inline void enqueue(unsigned idx) {
+        if (!m_enqueued[idx]) {
+            m_enqueued[idx] = true;
+            m_levelBuckets[m_levels[idx]].push_back(idx);
+        }
+    }
+
+    /**
+     * @brief compileDependencies
+     * Determines the value slots read by each operation (see readSlots()). Operations of state dependent components
+     * are sources, which are evaluated on every event-driven propagation.
+     */
+    void compileDependencies() {
+        const unsigned nSlots = m_values.size();
+        std::vector<std::vector<unsigned>> reads(m_operations.size());
+        std::vector<int> producer(nSlots, -1);
+
+        m_sourceOperations.clear();
+        for (unsigned idx = 0; idx < m_operations.size(); idx++) {
+            const auto& op = m_operations[idx];
+            producer[op.dst] = idx;
+            if (op.port->getParent<Component>()->isStateDependent())
+                m_sourceOperations.push_back(idx);
+            reads[idx] = readSlots(op);
+        }
+
+        // Levelize; the propagation stack is topologically ordered, so producers precede their readers
+        m_levels.assign(m_operations.size(), 0);
+        unsigned maxLevel = 0;
+        for (unsigned idx = 0; idx < m_operations.size(); idx++) {
+            for (const auto& slot : reads[idx]) {
+                const int p = producer[slot];
+                if (p >= 0 && static_cast<unsigned>(p) < idx)
+                    m_levels[idx] = std::max(m_levels[idx], m_levels[p] + 1);
+            }
+            maxLevel = std::max(maxLevel, m_levels[idx]);
+        }
+        m_levelBuckets.assign(m_operations.empty() ? 0 : maxLevel + 1, {});
+        m_enqueued.assign(m_operations.size(), false);
+
+        // Group operations by level for parallel propagation
+        m_levelOffsets.assign(m_levelBuckets.size() + 1, 0);
+        for (const auto& level : m_levels)
+            m_levelOffsets[level + 1]++;
+        for (unsigned i = 0; i < m_levelBuckets.size(); i++)
+            m_levelOffsets[i + 1] += m_levelOffsets[i];
+        m_levelOrder.resize(m_operations.size());
+        std::vector<unsigned> levelFill(m_levelOffsets.begin(), m_levelOffsets.end() - 1);
+        for (unsigned idx = 0; idx < m_operations.size(); idx++)
+            m_levelOrder[levelFill[m_levels[idx]]++] = idx;
+        m_changed.assign(m_operations.size(), 0);
+
+        // Build the slot -> reading operations fan-out table
+        m_fanoutOffsets.assign(nSlots + 1, 0);
+        for (const auto& r : reads)
+            for (const auto& slot : r)
+                m_fanoutOffsets[slot + 1]++;
+        for (unsigned i = 0; i < nSlots; i++)
+            m_fanoutOffsets[i + 1] += m_fanoutOffsets[i];
+        m_fanout.resize(m_fanoutOffsets[nSlots]);
+        std::vector<unsigned> fill(m_fanoutOffsets.begin(), m_fanoutOffsets.end() - 1);
+        for (unsigned idx = 0; idx < reads.size(); idx++)
+            for (const auto& slot : reads[idx])
+                m_fanout[fill[slot]++] = idx;
+    }
+
+    bool m_compiled = false;
+    std::map<const PortBase*, unsigned> m_slots;
+    unsigned m_nextSlot = 0;
+    std::vector<VSRTL_VT_U> m_values;
+    std::vector<PortBase*> m_ports;
+    // All operations of the propagation stack, and the operations selected for propagation
+    std::vector<Operation> m_allOperations;
+    std::vector<Operation> m_operations;
+
+    bool m_pruning = false;
+    std::set<const PortBase*> m_observed;
+
+    // Batched change notification; changed ports and their slots
+    bool m_batchedNotification = false;
+    std::vector<std::pair<PortBase*, unsigned>> m_dirty;
+
+    // Pass-through ports sharing each slot, indexed through m_aliasOffsets
+    std::vector<unsigned> m_aliasOffsets;
+    std::vector<PortBase*> m_aliases;
+
+    // Event-driven propagation
+    std::vector<unsigned> m_sourceOperations;
+    std::vector<unsigned> m_levels;
+    std::vector<unsigned> m_fanoutOffsets;
+    std::vector<unsigned> m_fanout;
+    std::vector<std::vector<unsigned>> m_levelBuckets;
+    std::vector<bool> m_enqueued;
+
+    // Parallel propagation; operation indices sorted by level, indexed through m_levelOffsets
+    std::vector<unsigned> m_levelOffsets;
+    std::vector<unsigned> m_levelOrder;
+    std::vector<unsigned char> m_changed;
+
+    // Bit-packed propagation. Groups are sorted by level; operations of group g are m_bitwiseOperations[g.begin;
+    // g.end[, with g.nOperands operands each
+    bool m_bitPacking = true;
+    std::vector<BitwiseGroup> m_bitwiseGroups;
+    std::vector<unsigned> m_bitwiseOperations;
+    std::vector<unsigned> m_bitwiseDst;
+    std::vector<BitOperand> m_bitwiseOperands;
+    std::vector<unsigned> m_scalarLevelOffsets;
+    std::vector<unsigned> m_scalarOrder;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_SCHEDULE_H
@@ -12,6 +12,20 @@ template <unsigned int W>
 class Shift : public Component {
 public:
     Shift(std::string name, SimComponent* parent, ShiftType t, unsigned int shamt) : Component(name, parent) {
+        if constexpr (isWideWidth(W)) {
+            out << [=] {
+                if (t == ShiftType::sl) {
+                    return in.wideValue() << shamt;
+                } else if (t == ShiftType::sra) {
+                    return in.wideValue().sra(shamt);
+                } else if (t == ShiftType::srl) {
+                    return in.wideValue() >> shamt;
+                } else {
+                    throw std::runtime_error("Unknown shift type");
+                }
+            };
+            return;
+        }
         out << [=] {
             if (t == ShiftType::sl) {
                 return in.template value<VSRTL_VT_U>() << shamt;
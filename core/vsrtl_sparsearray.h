@@ -1,33 +1,202 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <climits>
 #include <map>
-#include <unordered_map>
+#include <memory>
 #include <vector>
 #include "../interface/vsrtl.h"
 
 namespace vsrtl {
 namespace core {
 
+/**
+ * @brief The MemoryPages class
+ * Byte storage of a sparse address space. Memory is allocated on demand in pages of pageSize bytes, indexed through a
+ * two-level page table. Bytes of unallocated pages read as 0, and reading never allocates, such that a memory may be
+ * read concurrently.
+ * Page tables and pages are shared copy-on-write: copying a MemoryPages is O(1), and a page is only duplicated once
+ * either copy writes to it.
+ */
+class MemoryPages {
+public:
+    static constexpr unsigned pageBits = 12;
+    static constexpr unsigned pageSize = 1u << pageBits;
+    static constexpr unsigned tableBits = 10;
+    static constexpr unsigned directoryBits = sizeof(VSRTL_VT_U) * CHAR_BIT - pageBits - tableBits;
+    static_assert(directoryBits <= 16, "Page directory would be too large for the address width of VSRTL_VT_U");
+
+    using Page = std::array<uint8_t, pageSize>;
+
+    /**
+     * @brief page
+     * @returns the page containing @p address, or nullptr if the page is unallocated
+     */
+    const Page* page(VSRTL_VT_U address) const {
+        if (!m_directory)
+            return nullptr;
+        const auto& table = (*m_directory)[address >> (pageBits + tableBits)];
+        return table ? (*table)[(address >> pageBits) & (tableSize - 1)].get() : nullptr;
+    }
+
+    /**
+     * @brief allocate
+     * @returns the page containing @p address for writing, allocating a zeroed page or copying a shared page if
+     * required
+     */
+    Page* allocate(VSRTL_VT_U address) {
+        auto& table = unshare(unshare(m_directory)[address >> (pageBits + tableBits)]);
+        auto& page = table[(address >> pageBits) & (tableSize - 1)];
+        if (!page) {
+            // Value-initialized, ie. zeroed
+            page = std::make_shared<Page>();
+            m_pageCount++;
+        } else {
+            unshare(page);
+        }
+        return page.get();
+    }
+
+    uint8_t read(VSRTL_VT_U address) const {
+        const Page* p = page(address);
+        return p ? (*p)[address & (pageSize - 1)] : 0;
+    }
+
+    void write(VSRTL_VT_U address, uint8_t value) { (*allocate(address))[address & (pageSize - 1)] = value; }
+
+    /**
+     * @brief write
+     * Writes @p n bytes starting at @p address, resolving each page once.
+     */
+    void write(VSRTL_VT_U address, const uint8_t* bytes, size_t n) {
+        while (n > 0) {
+            const unsigned offset = address & (pageSize - 1);
+            const size_t chunk = std::min<size_t>(n, pageSize - offset);
+            std::copy(bytes, bytes + chunk, allocate(address)->begin() + offset);
+            address += chunk;
+            bytes += chunk;
+            n -= chunk;
+        }
+    }
+
+    /**
+     * @brief map
+     * Maps @p page as the page containing @p address, replacing any page currently mapped there. The page is shared
+     * copy-on-write; if other references to its owner exist, it is copied before being written.
+     */
+    void map(VSRTL_VT_U address, std::shared_ptr<Page> page) {
+        auto& table = unshare(unshare(m_directory)[address >> (pageBits + tableBits)]);
+        auto& entry = table[(address >> pageBits) & (tableSize - 1)];
+        if (!entry)
+            m_pageCount++;
+        entry = std::move(page);
+    }
+
+    /**
+     * @brief forEachPage
+     * Calls @p f(base address, page) for each allocated page, in address order.
+     */
+    template <typename F>
+    void forEachPage(const F& f) const {
+        forEachTable([&](unsigned d, const Table& table) {
+            for (unsigned t = 0; t < tableSize; t++) {
+                if (table[t])
+                    f(static_cast<VSRTL_VT_U>((d << (pageBits + tableBits)) | (t << pageBits)), *table[t]);
+            }
+        });
+    }
+
+    /**
+     * @brief operator==
+     * Compares the contents of two memories; unallocated pages compare equal to zeroed pages.
+     */
+    bool operator==(const MemoryPages& other) const {
+        return m_directory == other.m_directory || (includes(other) && other.includes(*this));
+    }
+    bool operator!=(const MemoryPages& other) const { return !(*this == other); }
+
+    size_t pageCount() const { return m_pageCount; }
+    bool empty() const { return m_pageCount == 0; }
+
+    void clear() {
+        m_directory.reset();
+        m_pageCount = 0;
+    }
+
+private:
+    static constexpr unsigned tableSize = 1u << tableBits;
+    static constexpr size_t directorySize = size_t(1) << directoryBits;
+    using Table = std::array<std::shared_ptr<Page>, tableSize>;
+    using Directory = std::array<std::shared_ptr<Table>, directorySize>;
+
+    /**
+     * @brief unshare
+     * Ensures that @p ptr is allocated and not shared with any other memory, copying it if required.
+     */
+    template <typename T>
+    static T& unshare(std::shared_ptr<T>& ptr) {
+        if (!ptr) {
+            ptr = std::make_shared<T>();
+        } else if (ptr.use_count() > 1) {
+            ptr = std::make_shared<T>(*ptr);
+        } else {
+            // Synchronizes with the release of any other reference, which may have been held by another thread
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *ptr;
+    }
+
+    template <typename F>
+    void forEachTable(const F& f) const {
+        if (!m_directory)
+            return;
+        for (unsigned d = 0; d < directorySize; d++) {
+            if ((*m_directory)[d])
+                f(d, *(*m_directory)[d]);
+        }
+    }
+
+    // Whether each allocated page of @p other is equal in this memory
+    bool includes(const MemoryPages& other) const {
+        bool equal = true;
+        other.forEachPage([&](VSRTL_VT_U base, const Page& page) {
+            const Page* p = this->page(base);
+            if (p ? *p != page : std::any_of(page.begin(), page.end(), [](uint8_t b) { return b != 0; }))
+                equal = false;
+        });
+        return equal;
+    }
+
+    std::shared_ptr<Directory> m_directory;
+    size_t m_pageCount = 0;
+};
+
 struct SparseArray {
     void writeMem(VSRTL_VT_U address, VSRTL_VT_U value, int size = sizeof(VSRTL_VT_U)) {
         // writes value from the given address start, and up to $size bytes of
         // $value
+        const unsigned offset = address & (MemoryPages::pageSize - 1);
+        if (offset + size <= MemoryPages::pageSize) {
+            // Access within a single page
+            uint8_t* bytes = data.allocate(address)->data() + offset;
+            for (int i = 0; i < size; i++) {
+                bytes[i] = value & 0xff;
+                value >>= 8;
+            }
+            return;
+        }
         for (int i = 0; i < size; i++) {
-            data[address + i] = value & 0xff;
+            data.write(address + i, value & 0xff);
             value >>= 8;
         }
     }
 
     template <bool byteIndexed = true>
-    VSRTL_VT_U readMem(VSRTL_VT_U address, unsigned width = 4) {
-        if constexpr (!byteIndexed)
-            address <<= 2;
-
-        VSRTL_VT_U value = 0;
-        for (unsigned i = 0; i < width; i++)
-            value |= data[address++] << (i * CHAR_BIT);
-
-        return value;
+    VSRTL_VT_U readMem(VSRTL_VT_U address, unsigned width = 4) const {
+        // Reading does not allocate pages, allowing for concurrent reads during parallel propagation
+        return readMemConst<byteIndexed>(address, width);
     }
 
     template <bool byteIndexed = true>
@@ -36,44 +205,59 @@ struct SparseArray {
             address <<= 2;
 
         VSRTL_VT_U value = 0;
-        for (unsigned i = 0; i < width; i++) {
-            value |= contains(address) ? data.at(address) << (i * CHAR_BIT) : 0;
-            address++;
+        const unsigned offset = address & (MemoryPages::pageSize - 1);
+        if (offset + width <= MemoryPages::pageSize) {
+            // Access within a single page
+            const auto* page = data.page(address);
+            if (!page)
+                return 0;
+            const uint8_t* bytes = page->data() + offset;
+            for (unsigned i = 0; i < width; i++)
+                value |= static_cast<VSRTL_VT_U>(bytes[i]) << (i * CHAR_BIT);
+            return value;
         }
-
+        for (unsigned i = 0; i < width; i++)
+            value |= static_cast<VSRTL_VT_U>(data.read(address + i)) << (i * CHAR_BIT);
         return value;
     }
 
-    bool contains(uint32_t address) const { return data.count(address) > 0; }
+    /**
+     * @brief contains
+     * @returns true if @p address lies within an allocated page of the memory, ie. a page which has been written to
+     */
+    bool contains(VSRTL_VT_U address) const { return data.page(address) != nullptr; }
 
     /**
      * @brief addInitializationMemory
      * The specified program will be added as a memory segment which will be loaded into this memory once it is reset.
+     * Programs are written into the initialization image in the order in which they are added, such that later programs
+     * overwrite overlapping bytes of earlier programs.
      */
     template <typename T>
     void addInitializationMemory(const VSRTL_VT_U startAddr, T* program, size_t n) {
-        auto& mem = initializationMemories.emplace_back();
         VSRTL_VT_U addr = startAddr;
         for (size_t i = 0; i < n; i++) {
-            // Add to initialization memories for future rewriting upon reset
-            mem.writeMem(addr, program[i], sizeof(T));
-            addr += sizeof(T);
+            // Add to the initialization image for future rewriting upon reset
+            VSRTL_VT_U value = program[i];
+            for (unsigned b = 0; b < sizeof(T); b++) {
+                initializationImage.write(addr++, value & 0xff);
+                value >>= 8;
+            }
         }
     }
 
-    void clearInitializationMemories() { initializationMemories.clear(); }
+    void clearInitializationMemories() { initializationImage.clear(); }
 
-    void reset() {
-        data.clear();
-        for (const auto& mem : initializationMemories) {
-            for (const auto& memData : mem.data) {
-                writeMem(memData.first, memData.second, sizeof(memData.second));
-            }
-        }
-    }
+    /**
+     * @brief reset
+     * Replaces the contents of the memory by the initialization image. Its pages are shared copy-on-write, such that
+     * resetting does not copy the image; only pages which are subsequently written are duplicated.
+     */
+    void reset() { data = initializationImage; }
 
-    std::unordered_map<VSRTL_VT_U, uint8_t> data;
-    std::vector<SparseArray> initializationMemories;
+    MemoryPages data;
+    // Composite of all initialization memories
+    MemoryPages initializationImage;
 };
 }  // namespace core
 }  // namespace vsrtl
@@ -0,0 +1,180 @@
+#ifndef VSRTL_STATE_H
+#define VSRTL_STATE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vsrtl_defines.h"
+#include "vsrtl_sparsearray.h"
+#include "vsrtl_widevalue.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The StateReader class
+ * Sequential reader of a word buffer written by the saveState() functions of clocked components. Components must read
+ * back exactly the words which they wrote, in the same order.
+ */
+class StateReader {
+public:
+    StateReader(const std::vector<VSRTL_VT_U>& words) : m_it(words.data()), m_end(words.data() + words.size()) {}
+    StateReader(const VSRTL_VT_U* begin, const VSRTL_VT_U* end) : m_it(begin), m_end(end) {}
+
+    VSRTL_VT_U read() {
+        if (m_it == m_end) {
+            throw std::runtime_error("Attempted to read beyond the end of a state buffer");
+        }
+        return *m_it++;
+    }
+
+    bool atEnd() const { return m_it == m_end; }
+
+private:
+    const VSRTL_VT_U* m_it;
+    const VSRTL_VT_U* m_end;
+};
+
+/**
+ * @brief saveValue, restoreValue
+ * Serialization of (possibly wide) state values; wide values occupy one word per limb.
+ */
+inline void saveValue(std::vector<VSRTL_VT_U>& state, VSRTL_VT_U value) {
+    state.push_back(value);
+}
+template <unsigned int W>
+void saveValue(std::vector<VSRTL_VT_U>& state, const WideValue<W>& value) {
+    for (unsigned i = 0; i < WideValue<W>::limbs; i++)
+        state.push_back(value.limb(i));
+}
+inline void restoreValue(StateReader& state, VSRTL_VT_U& value) {
+    value = state.read();
+}
+template <unsigned int W>
+void restoreValue(StateReader& state, WideValue<W>& value) {
+    std::array<VSRTL_VT_U, WideValue<W>::limbs> limbs;
+    for (auto& limb : limbs)
+        limb = state.read();
+    value = WideValue<W>::fromLimbs(limbs.data());
+}
+
+/**
+ * @brief The DesignState struct
+ * The complete simulation state of an elaborated design; the values of all ports, the state of all clocked
+ * components and the contents of all address spaces. Reverse history is not part of the state.
+ */
+struct DesignState {
+    std::vector<VSRTL_VT_U> portValues;
+    std::vector<VSRTL_VT_U> clockedState;
+    std::vector<SparseArray> memories;
+};
+
+/**
+ * @brief The BinaryState class
+ * The binary serialization format of design states. Port values are not stored, since they are a function of the
+ * clocked state and memory contents. All values are stored in host byte order:
+ * - magic and format version
+ * - design name, cycle count
+ * - clocked state (word count followed by the words)
+ * - memory count, followed by the page count and (base address, page) entries of each memory, in address order
+ */
+class BinaryState {
+public:
+    static void write(std::ostream& os, const std::string& design, long long cycle,
+                      const std::vector<VSRTL_VT_U>& clockedState, const std::vector<const SparseArray*>& memories) {
+        os.write(s_magic, sizeof(s_magic));
+        writeRaw(os, s_version);
+        writeRaw(os, static_cast<uint32_t>(design.size()));
+        os.write(design.data(), design.size());
+        writeRaw(os, static_cast<int64_t>(cycle));
+        writeWords(os, clockedState);
+
+        writeRaw(os, static_cast<uint32_t>(memories.size()));
+        for (const auto& mem : memories) {
+            writeRaw(os, static_cast<uint64_t>(mem->data.pageCount()));
+            mem->data.forEachPage([&os](VSRTL_VT_U base, const MemoryPages::Page& page) {
+                writeRaw(os, base);
+                os.write(reinterpret_cast<const char*>(page.data()), page.size());
+            });
+        }
+        if (!os) {
+            throw std::runtime_error("Failed to write design state");
+        }
+    }
+
+    /**
+     * @brief read
+     * Reads a state saved from @p design into @p state. The sizes of the clocked state and memories of @p state must
+     * be those of the design; the state is rejected if they differ.
+     */
+    static void read(std::istream& is, const std::string& design, long long& cycle, DesignState& state) {
+        char magic[sizeof(s_magic)];
+        is.read(magic, sizeof(magic));
+        if (!is || !std::equal(magic, magic + sizeof(magic), s_magic) || readRaw<uint32_t>(is) != s_version) {
+            throw std::runtime_error("Not a design state, or unsupported state format version");
+        }
+        std::string name(readRaw<uint32_t>(is), '\0');
+        is.read(&name[0], name.size());
+        if (name != design) {
+            throw std::runtime_error("State was saved from design '" + name + "', not '" + design + "'");
+        }
+        cycle = readRaw<int64_t>(is);
+        readWords(is, state.clockedState);
+
+        if (readRaw<uint32_t>(is) != state.memories.size()) {
+            throw std::runtime_error("State does not match the memories of the design");
+        }
+        for (auto& mem : state.memories) {
+            mem.data.clear();
+            for (auto n = readRaw<uint64_t>(is); n > 0; n--) {
+                auto& page = *mem.data.allocate(readRaw<VSRTL_VT_U>(is));
+                is.read(reinterpret_cast<char*>(page.data()), page.size());
+                check(is);
+            }
+        }
+    }
+
+private:
+    static constexpr char s_magic[8] = {'V', 'S', 'R', 'T', 'L', 'S', 'T', 'A'};
+    static constexpr uint32_t s_version = 2;
+
+    static void check(std::istream& is) {
+        if (!is) {
+            throw std::runtime_error("Unexpected end of design state");
+        }
+    }
+
+    template <typename T>
+    static void writeRaw(std::ostream& os, const T& value) {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template <typename T>
+    static T readRaw(std::istream& is) {
+        T value;
+        is.read(reinterpret_cast<char*>(&value), sizeof(T));
+        check(is);
+        return value;
+    }
+
+    static void writeWords(std::ostream& os, const std::vector<VSRTL_VT_U>& words) {
+        writeRaw(os, static_cast<uint32_t>(words.size()));
+        os.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(VSRTL_VT_U));
+    }
+    static void readWords(std::istream& is, std::vector<VSRTL_VT_U>& words) {
+        if (readRaw<uint32_t>(is) != words.size()) {
+            throw std::runtime_error("State does not match the structure of the design");
+        }
+        is.read(reinterpret_cast<char*>(words.data()), words.size() * sizeof(VSRTL_VT_U));
+        check(is);
+    }
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_STATE_H
@@ -0,0 +1,137 @@
+#ifndef VSRTL_THREADPOOL_H
+#define VSRTL_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The ThreadPool class
+ * A persistent pool of worker threads for executing fork-join parallel loops. A call to run(n, task) executes task(i)
+ * for all i in [0; n[, and returns once all tasks have finished. The calling thread participates in executing the
+ * tasks.
+ * Tasks are initially partitioned into contiguous ranges, one per thread. Once a thread has exhausted its own range,
+ * it steals tasks from the ranges of the other threads, balancing the load when task durations differ.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads) : m_ranges(std::max(threads, 1u)) {
+        for (unsigned i = 1; i < m_ranges.size(); i++) {
+            m_workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_terminate = true;
+        }
+        m_wakeWorkers.notify_all();
+        for (auto& w : m_workers)
+            w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned threadCount() const { return m_ranges.size(); }
+
+    void run(unsigned nTasks, const std::function<void(unsigned)>& task) {
+        if (nTasks == 0)
+            return;
+
+        const unsigned nThreads = m_ranges.size();
+        for (unsigned i = 0; i < nThreads; i++) {
+            m_ranges[i].next = (nTasks * i) / nThreads;
+            m_ranges[i].end = (nTasks * (i + 1)) / nThreads;
+        }
+        m_task = &task;
+        m_exception = nullptr;
+        m_activeWorkers = nThreads - 1;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_generation++;
+        }
+        m_wakeWorkers.notify_all();
+
+        execute(0);
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workersDone.wait(lock, [this] { return m_activeWorkers == 0; });
+        }
+        m_task = nullptr;
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    struct alignas(64) Range {
+        std::atomic<unsigned> next{0};
+        unsigned end = 0;
+    };
+
+    void workerLoop(unsigned id) {
+        unsigned long long seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeWorkers.wait(lock, [&] { return m_terminate || m_generation != seenGeneration; });
+                if (m_terminate)
+                    return;
+                seenGeneration = m_generation;
+            }
+            execute(id);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_activeWorkers--;
+            }
+            m_workersDone.notify_one();
+        }
+    }
+
+    void execute(unsigned id) {
+        const unsigned nThreads = m_ranges.size();
+        // Exhaust own range, then steal from the remaining ranges
+        for (unsigned k = 0; k < nThreads; k++) {
+            Range& range = m_ranges[(id + k) % nThreads];
+            unsigned idx;
+            while ((idx = range.next.fetch_add(1, std::memory_order_relaxed)) < range.end) {
+                try {
+                    (*m_task)(idx);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_exception)
+                        m_exception = std::current_exception();
+                }
+            }
+        }
+    }
+
+    std::vector<Range> m_ranges;
+    std::vector<std::thread> m_workers;
+    const std::function<void(unsigned)>* m_task = nullptr;
+    std::exception_ptr m_exception;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeWorkers;
+    std::condition_variable m_workersDone;
+    unsigned long long m_generation = 0;
+    unsigned m_activeWorkers = 0;
+    bool m_terminate = false;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_THREADPOOL_H
@@ -0,0 +1,171 @@
+#ifndef VSRTL_WIDEVALUE_H
+#define VSRTL_WIDEVALUE_H
+
+#include <limits.h>
+#include <algorithm>
+#include <array>
+
+#include "vsrtl_defines.h"
+
+namespace vsrtl {
+namespace core {
+
+constexpr unsigned int valueBits() {
+    return sizeof(VSRTL_VT_U) * CHAR_BIT;
+}
+
+/**
+ * @brief isWideWidth
+ * Ports wider than VSRTL_VT_U store their values as multiple words (limbs), and their components select multi-limb
+ * propagation functions at compile time.
+ */
+constexpr bool isWideWidth(unsigned int width) {
+    return width > valueBits();
+}
+
+constexpr unsigned int limbCount(unsigned int width) {
+    return width <= valueBits() ? 1 : (width + valueBits() - 1) / valueBits();
+}
+
+/**
+ * @brief The WideValue class
+ * A W-bit unsigned value stored as little-endian limbs of VSRTL_VT_U. Bits above W are always zero, such that
+ * arithmetic wraps around modulo 2^W, equivalent to the truncation applied to narrow ports.
+ */
+template <unsigned int W>
+class WideValue {
+public:
+    static constexpr unsigned int limbs = limbCount(W);
+
+    WideValue() = default;
+    WideValue(VSRTL_VT_U value) {
+        m_limbs[0] = value;
+        truncate();
+    }
+
+    static WideValue fromLimbs(const VSRTL_VT_U* limbs) {
+        WideValue v;
+        std::copy(limbs, limbs + WideValue::limbs, v.m_limbs.begin());
+        v.truncate();
+        return v;
+    }
+
+    /**
+     * @brief store
+     * Writes the limbs of this value to @p dst.
+     * @returns true if the value stored at @p dst changed
+     */
+    bool store(VSRTL_VT_U* dst) const {
+        if (std::equal(m_limbs.begin(), m_limbs.end(), dst))
+            return false;
+        std::copy(m_limbs.begin(), m_limbs.end(), dst);
+        return true;
+    }
+
+    VSRTL_VT_U limb(unsigned int i) const { return m_limbs[i]; }
+    VSRTL_VT_U lowWord() const { return m_limbs[0]; }
+
+    bool bit(unsigned int i) const { return (m_limbs[i / valueBits()] >> (i % valueBits())) & 1; }
+    void setBit(unsigned int i, bool value) {
+        const VSRTL_VT_U mask = VSRTL_VT_U(1) << (i % valueBits());
+        m_limbs[i / valueBits()] = value ? m_limbs[i / valueBits()] | mask : m_limbs[i / valueBits()] & ~mask;
+    }
+    bool msb() const { return bit(W - 1); }
+
+    WideValue operator+(const WideValue& rhs) const {
+        WideValue r;
+        VSRTL_VT_U carry = 0;
+        for (unsigned i = 0; i < limbs; i++) {
+            const VSRTL_VT_U sum = m_limbs[i] + rhs.m_limbs[i];
+            r.m_limbs[i] = sum + carry;
+            carry = (sum < m_limbs[i]) || (r.m_limbs[i] < sum);
+        }
+        r.truncate();
+        return r;
+    }
+
+    WideValue operator-(const WideValue& rhs) const { return *this + (~rhs + WideValue(1)); }
+
+    WideValue operator~() const {
+        WideValue r;
+        for (unsigned i = 0; i < limbs; i++)
+            r.m_limbs[i] = ~m_limbs[i];
+        r.truncate();
+        return r;
+    }
+
+    WideValue operator&(const WideValue& rhs) const {
+        WideValue r;
+        for (unsigned i = 0; i < limbs; i++)
+            r.m_limbs[i] = m_limbs[i] & rhs.m_limbs[i];
+        return r;
+    }
+    WideValue operator|(const WideValue& rhs) const {
+        WideValue r;
+        for (unsigned i = 0; i < limbs; i++)
+            r.m_limbs[i] = m_limbs[i] | rhs.m_limbs[i];
+        return r;
+    }
+    WideValue operator^(const WideValue& rhs) const {
+        WideValue r;
+        for (unsigned i = 0; i < limbs; i++)
+            r.m_limbs[i] = m_limbs[i] ^ rhs.m_limbs[i];
+        return r;
+    }
+
+    WideValue operator<<(unsigned int shamt) const {
+        WideValue r;
+        if (shamt >= W)
+            return r;
+        const unsigned limbShift = shamt / valueBits();
+        const unsigned bitShift = shamt % valueBits();
+        for (unsigned i = limbs; i-- > limbShift;) {
+            VSRTL_VT_U v = m_limbs[i - limbShift] << bitShift;
+            if (bitShift != 0 && i > limbShift)
+                v |= m_limbs[i - limbShift - 1] >> (valueBits() - bitShift);
+            r.m_limbs[i] = v;
+        }
+        r.truncate();
+        return r;
+    }
+
+    // Logical right shift
+    WideValue operator>>(unsigned int shamt) const {
+        WideValue r;
+        if (shamt >= W)
+            return r;
+        const unsigned limbShift = shamt / valueBits();
+        const unsigned bitShift = shamt % valueBits();
+        for (unsigned i = 0; i + limbShift < limbs; i++) {
+            VSRTL_VT_U v = m_limbs[i + limbShift] >> bitShift;
+            if (bitShift != 0 && i + limbShift + 1 < limbs)
+                v |= m_limbs[i + limbShift + 1] << (valueBits() - bitShift);
+            r.m_limbs[i] = v;
+        }
+        return r;
+    }
+
+    // Arithmetic right shift
+    WideValue sra(unsigned int shamt) const {
+        if (!msb())
+            return *this >> shamt;
+        return ~(~*this >> shamt);
+    }
+
+    bool operator==(const WideValue& rhs) const { return m_limbs == rhs.m_limbs; }
+    bool operator!=(const WideValue& rhs) const { return m_limbs != rhs.m_limbs; }
+
+private:
+    void truncate() {
+        if constexpr (W % valueBits() != 0) {
+            m_limbs[limbs - 1] &= (VSRTL_VT_U(1) << (W % valueBits())) - 1;
+        }
+    }
+
+    std::array<VSRTL_VT_U, limbs> m_limbs{};
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_WIDEVALUE_H
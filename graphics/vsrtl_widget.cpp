@@ -166,12 +166,9 @@ void VSRTLWidget::clock() {
 
 void VSRTLWidget::run() {
     if (m_design) {
-        m_design->setEnableSignals(false);
-        while (!m_stop) {
-            m_design->clock();
-        }
+        m_design->runCycles(SimDesign::unboundedCycles, [this] { return m_stop; });
         m_stop = false;
-        m_design->setEnableSignals(true);
+        isReversible();
         m_scene->update();
     }
 }
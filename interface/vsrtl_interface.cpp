@@ -1,6 +1,17 @@
 #include "vsrtl_interface.h"
 
+#include <mutex>
+#include <unordered_set>
+
 namespace vsrtl {
+const std::string* internName(const std::string& name) {
+    static std::mutex mutex;
+    // Elements of an unordered_set are never relocated
+    static std::unordered_set<std::string> names;
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*names.insert(name).first;
+}
+
 SimDesign* SimBase::getDesign() {
     if (m_design)
         return m_design;
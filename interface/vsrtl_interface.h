@@ -2,10 +2,13 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <fstream>
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <type_traits>
 #include <typeindex>
 #include <vector>
@@ -25,9 +28,73 @@ class SimComponent;
 class SimDesign;
 class SimSynchronous;
 
+/**
+ * @brief internName
+ * Names of simulator objects are interned, such that objects sharing a name (ie. the "out" ports of all components)
+ * share its storage. Interned names are kept for the lifetime of the program.
+ * @returns the interned copy of @p name
+ */
+const std::string* internName(const std::string& name);
+
+/**
+ * @brief The LazySignal class
+ * A signal which is only allocated once a slot is connected to it. Most ports and components of a design are never
+ * connected to (ie. when simulating without a graphical frontend), in which case the signal occupies a single pointer,
+ * and emitting it is a null check.
+ */
+template <typename Signal>
+class LazySignal {
+public:
+    template <typename... Args>
+    void Connect(Args&&... args) {
+        if (!m_signal)
+            m_signal = std::make_unique<Signal>();
+        m_signal->Connect(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void Disconnect(Args&&... args) {
+        if (m_signal)
+            m_signal->Disconnect(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void Emit(Args&&... args) const {
+        if (m_signal)
+            m_signal->Emit(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void operator()(Args&&... args) const {
+        Emit(std::forward<Args>(args)...);
+    }
+
+    bool isAllocated() const { return m_signal != nullptr; }
+    size_t getFootprint() const { return m_signal ? sizeof(Signal) : 0; }
+
+private:
+    std::unique_ptr<Signal> m_signal;
+};
+
+/**
+ * @brief The Footprint struct
+ * Memory occupied by the ports and components of a design, including the memory allocated by them. Memory of ordered
+ * containers is estimated, and component sizes exclude members declared by component subclasses (ie. pointers to
+ * subcomponents and ports).
+ */
+struct Footprint {
+    size_t ports = 0;
+    size_t portBytes = 0;
+    size_t components = 0;
+    size_t componentBytes = 0;
+
+    double bytesPerPort() const { return ports ? static_cast<double>(portBytes) / ports : 0; }
+    double bytesPerComponent() const { return components ? static_cast<double>(componentBytes) / components : 0; }
+};
+
 class SimBase {
 public:
-    SimBase(std::string name, SimBase* parent) : m_name(name), m_parent(parent) {}
+    SimBase(std::string name, SimBase* parent) : m_name(internName(name)), m_parent(parent) {}
     virtual ~SimBase() {}
 
     SimDesign* getDesign();
@@ -37,15 +104,15 @@ public:
         throw T(getName() + ": " + message);
     }
 
-    const std::string& getName() const { return m_name; }
-    const std::string& getDisplayName() const { return m_displayName.empty() ? m_name : m_displayName; }
+    const std::string& getName() const { return *m_name; }
+    const std::string& getDisplayName() const { return m_displayName ? *m_displayName : *m_name; }
 
     template <typename T = SimBase>
     T* getParent() const {
         return dynamic_cast<T*>(m_parent);
     }
 
-    void setDisplayName(std::string name) { m_displayName = name; }
+    void setDisplayName(std::string name) { m_displayName = name.empty() ? nullptr : internName(name); }
 
     template <typename T>
     void registerGraphic(T* obj) {
@@ -61,18 +128,25 @@ public:
     }
 
 protected:
-    std::string m_name;
+    const std::string* m_name;
     SimBase* m_parent = nullptr;
     SimDesign* m_design = nullptr;
-    std::string m_displayName;
+    const std::string* m_displayName = nullptr;
     void* m_graphicObject = nullptr;
 };
 
 template <typename T>
 struct BaseSorter {
-    bool operator()(const T& lhs, const T& rhs) const {
-        return std::lexicographical_compare(lhs->getName().begin(), lhs->getName().end(), rhs->getName().begin(),
-                                            rhs->getName().end());
+    // Allows for looking up objects by name
+    using is_transparent = void;
+
+    bool operator()(const T& lhs, const T& rhs) const { return compare(lhs->getName(), rhs->getName()); }
+    bool operator()(const T& lhs, const std::string& rhs) const { return compare(lhs->getName(), rhs); }
+    bool operator()(const std::string& lhs, const T& rhs) const { return compare(lhs, rhs->getName()); }
+
+private:
+    static bool compare(const std::string& lhs, const std::string& rhs) {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 };
 
@@ -176,9 +250,19 @@ public:
     virtual std::string valueToEnumString() const { throw std::runtime_error("This is not an enum port!"); }
     virtual VSRTL_VT_U enumStringToValue(const char*) const { throw std::runtime_error("This is not an enum port!"); }
 
-    Gallant::Signal0<> changed;
+    LazySignal<Gallant::Signal0<>> changed;
+
+    /**
+     * @brief getFootprint
+     * @returns the number of bytes occupied by this port, including memory allocated by it
+     */
+    virtual size_t getFootprint() const { return sizeof(SimPort) + getAllocatedFootprint(); }
 
 protected:
+    size_t getAllocatedFootprint() const {
+        return m_outputPorts.capacity() * sizeof(SimPort*) + changed.getFootprint();
+    }
+
     std::vector<SimPort*> m_outputPorts;
     SimPort* m_inputPort = nullptr;
 
@@ -275,8 +359,8 @@ public:
     T* getSpecialPort(const std::string& id) const {
         static_assert(std::is_base_of<SimPort, T>::value, "Must cast to a simulator-specific port type");
         verifyHasSpecialPortID(id);
-        if (m_specialPorts.count(id) != 0)
-            return m_specialPorts.at(id);
+        if (m_specialPorts && m_specialPorts->count(id) != 0)
+            return m_specialPorts->at(id);
         return nullptr;
     }
 
@@ -284,8 +368,9 @@ public:
     std::vector<T*> getSpecialPorts() const {
         static_assert(std::is_base_of<SimPort, T>::value, "Must cast to a simulator-specific port type");
         std::vector<T*> ports;
-        for (const auto& p : m_specialPorts) {
-            ports.push_back(p.second);
+        if (m_specialPorts) {
+            for (const auto& p : *m_specialPorts)
+                ports.push_back(p.second);
         }
         return ports;
     }
@@ -294,7 +379,9 @@ public:
         verifyHasSpecialPortID(id);
         if (getSpecialPort(id) != nullptr)
             throwError("Special port '" + id + "' already set");
-        m_specialPorts[id] = port;
+        if (!m_specialPorts)
+            m_specialPorts = std::make_unique<std::map<std::string, SimPort*>>();
+        (*m_specialPorts)[id] = port;
     }
 
     template <typename T = SimComponent, typename P = NoPredicate>
@@ -336,6 +423,7 @@ public:
     template <typename T, typename... Args>
     std::vector<T*> create_components(std::string name, unsigned int n, Args... args) {
         std::vector<T*> components;
+        components.reserve(n);
         for (unsigned int i = 0; i < n; i++) {
             std::string i_name = name + "_" + std::to_string(i);
             components.push_back(create_component<T, Args...>(i_name, args...));
@@ -376,8 +464,13 @@ public:
 
     template <typename T, typename C_T>
     bool isUniqueName(const std::string& name, std::set<std::unique_ptr<T>, C_T>& container) {
-        return std::find_if(container.begin(), container.end(),
-                            [name](const auto& p) { return p->getName() == name; }) == container.end();
+        if constexpr (std::is_same<C_T, BaseSorter<std::unique_ptr<T>>>::value) {
+            // Containers sorted by name are searched by name
+            return container.find(name) == container.end();
+        } else {
+            return std::find_if(container.begin(), container.end(),
+                                [name](const auto& p) { return p->getName() == name; }) == container.end();
+        }
     }
 
     template <typename T>
@@ -400,16 +493,51 @@ public:
     bool isSynchronous() const { return m_synchronous != nullptr; }
     SimSynchronous* getSynchronous() { return m_synchronous; }
 
-    Gallant::Signal0<> changed;
+    LazySignal<Gallant::Signal0<>> changed;
+
+    /**
+     * @brief getFootprint
+     * @returns the number of bytes occupied by this component, including memory allocated by it, but excluding its
+     * ports and subcomponents
+     */
+    virtual size_t getFootprint() const { return sizeof(SimComponent) + getAllocatedFootprint(); }
+
+    /**
+     * @brief accumulateFootprint
+     * Adds the footprint of this component, its ports and (recursively) its subcomponents to @p footprint.
+     */
+    void accumulateFootprint(Footprint& footprint) const {
+        footprint.components++;
+        footprint.componentBytes += getFootprint();
+        for (const auto* ports : {&m_inputPorts, &m_outputPorts}) {
+            for (const auto& p : *ports) {
+                footprint.ports++;
+                footprint.portBytes += p->getFootprint();
+            }
+        }
+        for (const auto& c : m_subcomponents)
+            c->accumulateFootprint(footprint);
+    }
 
 protected:
+    size_t getAllocatedFootprint() const {
+        // Nodes of ordered containers hold their value, three links and a color
+        constexpr size_t nodeSize = sizeof(void*) * 4 + sizeof(std::unique_ptr<SimBase>);
+        size_t bytes = (m_inputPorts.size() + m_outputPorts.size() + m_subcomponents.size() + m_parameters.size()) *
+                       nodeSize;
+        if (m_specialPorts)
+            bytes += sizeof(*m_specialPorts) + m_specialPorts->size() * (nodeSize + sizeof(std::string));
+        return bytes + changed.getFootprint();
+    }
+
     // Ports and subcomponents should be maintained as sorted sets based on port and component names, ensuring
     // consistent ordering between executions
     std::set<std::unique_ptr<SimPort>, PortBaseCompT> m_outputPorts;
     std::set<std::unique_ptr<SimPort>, PortBaseCompT> m_inputPorts;
     std::set<std::unique_ptr<SimComponent>, ComponentCompT> m_subcomponents;
     std::set<std::unique_ptr<ParameterBase>> m_parameters;
-    std::map<std::string, SimPort*> m_specialPorts;
+    // Allocated once a special port is set, which only few components do
+    std::unique_ptr<std::map<std::string, SimPort*>> m_specialPorts;
 
 private:
     unsigned m_constantCount = 0;  // Number of constants currently initialized in the component
@@ -428,7 +556,6 @@ public:
     SimSynchronous(SimComponent* parent) : m_parent(parent) { m_parent->registerSynchronous(this); }
     virtual ~SimSynchronous() {}
     virtual void reset() = 0;
-    virtual void reverse() = 0;
     virtual void forceValue(VSRTL_VT_U addr, VSRTL_VT_U value) = 0;
 
 private:
@@ -441,8 +568,30 @@ private:
 
 class SimDesign : public SimComponent {
 public:
+    /**
+     * @brief The RunResult struct
+     * Outcome of runCycles(); the reason for which the run stopped, and the number of cycles which were simulated.
+     */
+    struct RunResult {
+        enum class StopReason { cycleLimit, stopCondition, breakpoint };
+        StopReason reason = StopReason::cycleLimit;
+        long long cycles = 0;
+    };
+    static constexpr long long unboundedCycles = std::numeric_limits<long long>::max();
+
     SimDesign(std::string name, SimBase* parent) : SimComponent(name, parent) {}
     virtual ~SimDesign() {}
+
+    /**
+     * @brief getDesignFootprint
+     * @returns the memory occupied by the ports and components of the design
+     */
+    Footprint getDesignFootprint() const {
+        Footprint footprint;
+        accumulateFootprint(footprint);
+        return footprint;
+    }
+
     /**
      * @brief clock
      * Simulates clocking the circuit. Registers are clocked and the propagation algorithm is run
@@ -476,6 +625,30 @@ public:
      */
     virtual bool canReverse() const = 0;
 
+    /**
+     * @brief runCycles
+     * Clocks the circuit up to @p cycles times, with signals disabled. @p stop is evaluated after each cycle, and
+     * stops the run once it returns true. Unless @p reverseHistory is set, the simulator may omit recording reverse
+     * history for the simulated cycles; the run can then not be reversed.
+     * Observers of the circuit are not notified of the changes made during the run.
+     */
+    virtual RunResult runCycles(long long cycles, const std::function<bool()>& stop = {},
+                                bool /* reverseHistory */ = false) {
+        RunResult result;
+        const bool emitSignals = signalsEnabled();
+        setEnableSignals(false);
+        while (result.cycles < cycles) {
+            clock();
+            result.cycles++;
+            if (stop && stop()) {
+                result.reason = RunResult::StopReason::stopCondition;
+                break;
+            }
+        }
+        setEnableSignals(emitSignals);
+        return result;
+    }
+
     /**
      * @brief verifyAndInitialize
      * Any post-construction initialization should be included in this function.
@@ -494,6 +667,42 @@ public:
 
     virtual void setSynchronousValue(SimSynchronous* c, VSRTL_VT_U addr, VSRTL_VT_U value) = 0;
 
+    /**
+     * @brief saveState, restoreState
+     * Serializes the simulation state of the design (the cycle count, clocked state and memory contents) in a binary
+     * format, respectively restores it. Port values are not stored; restoring a state propagates the design to
+     * recompute them. A state may only be restored into an instance of the design which it was saved from. Reverse
+     * history is not part of the state.
+     */
+    virtual void saveState(std::ostream& /* os */) const {
+        throw std::runtime_error("Design does not support saving state");
+    }
+    virtual void restoreState(std::istream& /* is */) {
+        throw std::runtime_error("Design does not support restoring state");
+    }
+
+    void saveStateToFile(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Could not open '" + path + "' for writing");
+        }
+        saveState(file);
+    }
+    void restoreStateFromFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Could not open '" + path + "' for reading");
+        }
+        restoreState(file);
+    }
+
+    /**
+     * @brief observe
+     * Declares that the value of @p port is of interest. Simulators may omit evaluating ports which are not observed,
+     * and which do not affect the state of the circuit.
+     */
+    virtual void observe(const SimPort* /* port */) {}
+
 protected:
     long long m_cycleCount = 0;
     bool m_emitsSignals = true;
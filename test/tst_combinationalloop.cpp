@@ -0,0 +1,101 @@
+#include <QtTest/QTest>
+
+#include "vsrtl_adder.h"
+#include "vsrtl_constant.h"
+#include "vsrtl_design.h"
+#include "vsrtl_logicgate.h"
+#include "vsrtl_register.h"
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_CombinationalLoop : public QObject {
+    Q_OBJECT
+private slots:
+    void detectsLoops();
+    void registersCutLoops();
+};
+
+namespace {
+
+/**
+ * Two independent combinational loops: a pair of adders feeding each other, and a gate feeding itself
+ */
+class Loops : public Design {
+public:
+    Loops() : Design("Loops") {
+        a1->out >> a2->op1;
+        a2->out >> a1->op1;
+        1 >> a1->op2;
+        1 >> a2->op2;
+
+        gate->out >> *gate->in[0];
+        0 >> *gate->in[1];
+    }
+
+    SUBCOMPONENT(a1, Adder<8>);
+    SUBCOMPONENT(a2, Adder<8>);
+    SUBCOMPONENT(gate, TYPE(Xor<1, 2>));
+};
+
+/**
+ * A ring of adders, cut by a register
+ */
+class RegisteredRing : public Design {
+public:
+    RegisteredRing() : Design("Registered ring") {
+        for (unsigned i = 0; i < adders.size(); i++) {
+            adders[i]->out >> (i + 1 == adders.size() ? reg->in : adders[i + 1]->op1);
+            1 >> adders[i]->op2;
+        }
+        reg->out >> adders[0]->op1;
+    }
+
+    SUBCOMPONENTS(adders, Adder<8>, 16);
+    SUBCOMPONENT(reg, Register<8>);
+};
+
+}  // namespace
+
+void tst_CombinationalLoop::detectsLoops() {
+    Loops design;
+    const auto loops = design.findCombinationalLoops();
+    QCOMPARE(loops.size(), size_t(2));
+
+    // Each loop is reported with the full path of ports along it
+    std::vector<std::string> paths;
+    for (const auto& loop : loops) {
+        std::string path;
+        for (const auto& port : loop)
+            path += CombinationalLoopDetector::portPath(port) + " ";
+        paths.push_back(path);
+    }
+    std::sort(paths.begin(), paths.end());
+    QCOMPARE(loops[0].size() + loops[1].size(), size_t(6));
+    QVERIFY(paths[0].find("Loops.a1:op1") != std::string::npos);
+    QVERIFY(paths[0].find("Loops.a1:out") != std::string::npos);
+    QVERIFY(paths[0].find("Loops.a2:op1") != std::string::npos);
+    QVERIFY(paths[0].find("Loops.a2:out") != std::string::npos);
+    QVERIFY(paths[0].find("op2") == std::string::npos);
+    QVERIFY(paths[1].find("Loops.gate:out") != std::string::npos);
+
+    try {
+        design.verifyAndInitialize();
+        QFAIL("Combinational loops were not rejected");
+    } catch (const std::runtime_error& e) {
+        const std::string message = e.what();
+        QVERIFY(message.find("Loop 1: ") != std::string::npos);
+        QVERIFY(message.find("Loop 2: ") != std::string::npos);
+    }
+}
+
+void tst_CombinationalLoop::registersCutLoops() {
+    RegisteredRing design;
+    QVERIFY(design.findCombinationalLoops().empty());
+    design.verifyAndInitialize();
+    design.clock();
+    QCOMPARE(design.reg->out.uValue(), 16u);
+}
+
+QTEST_APPLESS_MAIN(tst_CombinationalLoop)
+#include "tst_combinationalloop.moc"
@@ -1,6 +1,9 @@
 #include <QtTest/QTest>
 
+#include "vsrtl_adder.h"
+#include "vsrtl_constant.h"
 #include "vsrtl_counter.h"
+#include "vsrtl_shift.h"
 
 #include <cmath>
 
@@ -11,8 +14,34 @@ class tst_counter : public QObject {
     Q_OBJECT
 private slots:
     void clockTest();
+    void runCycles();
+    void breakpoints();
+    void wideBreakpointEdges();
+    void unboundedReverse();
 };
 
+namespace {
+
+/**
+ * A 40-bit counter, incrementing by 2^shift each cycle
+ */
+template <unsigned int shift>
+class WideStepCounter : public vsrtl::core::Design {
+public:
+    WideStepCounter() : Design("Wide step counter") {
+        1 >> step->in;
+        step->out >> adder->op1;
+        reg->out >> adder->op2;
+        adder->out >> reg->in;
+    }
+
+    SUBCOMPONENT(step, vsrtl::core::Shift<40>, vsrtl::core::ShiftType::sl, shift);
+    SUBCOMPONENT(adder, vsrtl::core::Adder<40>);
+    SUBCOMPONENT(reg, vsrtl::core::Register<40>);
+};
+
+}  // namespace
+
 template <int n>
 void testCounter() {
     vsrtl::core::Counter<n> counter;
@@ -41,5 +70,149 @@ void tst_counter::clockTest() {
     testCounter<4>();
     testCounter<8>();
 }
+void tst_counter::runCycles() {
+    vsrtl::core::Counter<8> counter;
+    counter.verifyAndInitialize();
+    counter.clock();
+    QVERIFY(counter.canReverse());
+
+    // Running to the cycle limit, without reverse history
+    auto result = counter.runCycles(100);
+    QVERIFY(result.reason == SimDesign::RunResult::StopReason::cycleLimit);
+    QCOMPARE(result.cycles, 100ll);
+    QCOMPARE(counter.getCycleCount(), 101ll);
+    QCOMPARE(counter.value->out.uValue(), 101u);
+    QVERIFY(!counter.canReverse());
+    QVERIFY(counter.signalsEnabled());
+
+    // Running until the stop condition holds
+    result = counter.runCycles(SimDesign::unboundedCycles, [&] { return counter.value->out.uValue() == 0; });
+    QVERIFY(result.reason == SimDesign::RunResult::StopReason::stopCondition);
+    QCOMPARE(result.cycles, 155ll);
+
+    // Running with reverse history may be reversed
+    result = counter.runCycles(10, {}, true);
+    QCOMPARE(result.cycles, 10ll);
+    QVERIFY(counter.canReverse());
+    counter.reverse();
+    QCOMPARE(counter.value->out.uValue(), 9u);
+
+    // Clocking resumes recording reverse history
+    counter.runCycles(5);
+    counter.clock();
+    counter.clock();
+    counter.reverse();
+    counter.reverse();
+    QVERIFY(!counter.canReverse());
+    QCOMPARE(counter.value->out.uValue(), 14u);
+}
+
+void tst_counter::breakpoints() {
+    vsrtl::core::Counter<8> counter;
+    counter.verifyAndInitialize();
+
+    // Value condition
+    const auto atValue = counter.addBreakpoint(counter.value->out, WatchCondition::equal, 0x40);
+    auto result = counter.runCycles(SimDesign::unboundedCycles);
+    QVERIFY(result.reason == SimDesign::RunResult::StopReason::breakpoint);
+    QCOMPARE(result.cycles, 0x40ll);
+    QVERIFY(counter.getBreakpointHits() == std::vector<BreakpointId>({atValue}));
+
+    // Edge condition
+    counter.removeBreakpoint(atValue);
+    const auto msbRises = counter.addBreakpoint(counter.regs[7]->out, WatchCondition::rising);
+    result = counter.runCycles(1000);
+    QVERIFY(result.reason == SimDesign::RunResult::StopReason::breakpoint);
+    QCOMPARE(counter.value->out.uValue(), 0x80u);
+    QVERIFY(counter.getBreakpointHits() == std::vector<BreakpointId>({msbRises}));
+
+    // Conjunction of an edge and a value condition
+    counter.clearBreakpoints();
+    QVERIFY(counter.getBreakpointHits().empty());
+    const auto lsbFallsAbove =
+        counter.addBreakpoint({{&counter.regs[0]->out, WatchCondition::falling, 0},
+                               {&counter.value->out, WatchCondition::greater, 200}});
+    result = counter.runCycles(1000);
+    QVERIFY(result.reason == SimDesign::RunResult::StopReason::breakpoint);
+    QCOMPARE(counter.value->out.uValue(), 202u);
+    QVERIFY(counter.getBreakpointHits() == std::vector<BreakpointId>({lsbFallsAbove}));
+
+    // Breakpoints are checked when clocking, but not when the state is modified through other means
+    counter.clock();
+    QVERIFY(counter.getBreakpointHits().empty());
+    counter.clock();
+    QVERIFY(counter.getBreakpointHits() == std::vector<BreakpointId>({lsbFallsAbove}));
+    counter.reverse();
+    counter.clock();
+    QVERIFY(counter.getBreakpointHits() == std::vector<BreakpointId>({lsbFallsAbove}));
+    counter.reset();
+    counter.setSynchronousValue(counter.regs[0], 0, 1);
+    counter.setSynchronousValue(counter.outputReg, 0, 210);
+    QVERIFY(counter.getBreakpointHits().empty());
+}
+
+void tst_counter::wideBreakpointEdges() {
+    using namespace vsrtl::core;
+
+    // The least significant word of the counter wraps to 0 every other cycle, while the counter remains non-zero until
+    // it wraps after 2^9 cycles
+    WideStepCounter<31> falling;
+    falling.verifyAndInitialize();
+    falling.addBreakpoint(falling.reg->out, WatchCondition::falling);
+    auto result = falling.runCycles(1000);
+    QVERIFY(result.reason == SimDesign::RunResult::StopReason::breakpoint);
+    QCOMPARE(result.cycles, 512ll);
+    QVERIFY(falling.reg->out.wideValue() == WideValue<40>(0));
+
+    // The counter rises from 0 while its least significant word remains 0
+    WideStepCounter<32> rising;
+    rising.verifyAndInitialize();
+    rising.addBreakpoint(rising.reg->out, WatchCondition::rising);
+    result = rising.runCycles(1000);
+    QVERIFY(result.reason == SimDesign::RunResult::StopReason::breakpoint);
+    QCOMPARE(result.cycles, 1ll);
+    QCOMPARE(rising.reg->out.wideValue().limb(1), 1u);
+}
+
+void tst_counter::unboundedReverse() {
+    vsrtl::core::Counter<8> counter;
+    counter.setCheckpointInterval(4, 8);
+    counter.verifyAndInitialize();
+
+    // History is retained beyond the checkpoint limit, by thinning out checkpoints
+    constexpr unsigned cycles = 1000;
+    for (unsigned i = 0; i < cycles; i++)
+        counter.clock();
+    for (unsigned i = cycles; i > 0; i--) {
+        QVERIFY(counter.canReverse());
+        QCOMPARE(counter.value->out.uValue(), i % 256);
+        counter.reverse();
+        QCOMPARE(counter.getCycleCount(), static_cast<long long>(i - 1));
+    }
+    QCOMPARE(counter.value->out.uValue(), 0u);
+    QVERIFY(!counter.canReverse());
+
+    // Forced values are part of the history of the following cycles
+    for (unsigned i = 0; i < 10; i++)
+        counter.clock();
+    for (unsigned i = 0; i < 8; i++)
+        counter.setSynchronousValue(counter.regs[i], 0, (100 >> i) & 1);
+    QCOMPARE(counter.value->out.uValue(), 100u);
+    for (unsigned i = 0; i < 10; i++)
+        counter.clock();
+    for (unsigned i = 0; i < 10; i++)
+        counter.reverse();
+    QCOMPARE(counter.value->out.uValue(), 100u);
+    counter.reverse();
+    QCOMPARE(counter.value->out.uValue(), 9u);
+
+    // Clocking after reversing discards the reversed cycles
+    counter.clock();
+    counter.clock();
+    QCOMPARE(counter.value->out.uValue(), 11u);
+    counter.reverse();
+    QCOMPARE(counter.value->out.uValue(), 10u);
+}
+
 QTEST_APPLESS_MAIN(tst_counter)
 #include "tst_counter.moc"
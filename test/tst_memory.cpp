@@ -2,6 +2,10 @@
 
 #include "../interface/vsrtl_binutils.h"
 #include "vsrtl_core.h"
+#include "vsrtl_programloader.h"
+
+#include <filesystem>
+#include <fstream>
 
 namespace vsrtl {
 using namespace core;
@@ -80,6 +84,39 @@ public:
     ADDRESSSPACE(m_memory);
 };
 
+/**
+ * @brief The DualWritePorts design
+ * Two write ports of a single address space, writing overlapping bytes in the same cycle
+ */
+class DualWritePorts : public Design {
+public:
+    DualWritePorts() : Design("Dual write ports") {
+        wrA->setMemory(m_memory);
+        wrB->setMemory(m_memory);
+
+        counter->out >> inc->op1;
+        1 >> inc->op2;
+        inc->out >> counter->in;
+
+        0 >> wrA->addr;
+        counter->out >> wrA->data_in;
+        4 >> wrA->wr_width;
+        1 >> wrA->wr_en;
+
+        2 >> wrB->addr;
+        inc->out >> wrB->data_in;
+        2 >> wrB->wr_width;
+        1 >> wrB->wr_en;
+    }
+
+    SUBCOMPONENT(counter, Register<32>);
+    SUBCOMPONENT(inc, Adder<32>);
+    SUBCOMPONENT(wrA, TYPE(WrMemory<32, 32>));
+    SUBCOMPONENT(wrB, TYPE(WrMemory<32, 32>));
+
+    ADDRESSSPACE(m_memory);
+};
+
 }  // namespace vsrtl
 
 class tst_memory : public QObject {
@@ -88,6 +125,10 @@ private slots:
 
     void repeatedWriteSameIdxSync();
     void functionalTest();
+    void reverseJournaled();
+    void reverseOverlappingWrites();
+    void pagedSparseArray();
+    void programLoaders();
 };
 
 void tst_memory::functionalTest() {
@@ -116,5 +157,223 @@ void tst_memory::repeatedWriteSameIdxSync() {
     }
 }
 
+void tst_memory::reverseJournaled() {
+    vsrtl::ContinuousIncrement a;
+    // A journal holding only a few cycles, such that reversing alternates between reverting journaled deltas and
+    // replaying from checkpoints
+    a.setJournalCapacity(64);
+    a.setCheckpointInterval(16);
+    a.verifyAndInitialize();
+
+    const int n = 300;
+    std::vector<std::vector<vsrtl::VSRTL_VT_U>> trace;
+    auto sample = [&] {
+        std::vector<vsrtl::VSRTL_VT_U> values = {a.idx_reg->out.uValue(), a.acc_reg->out.uValue(),
+                                          a.mem->data_out.uValue()};
+        for (unsigned addr = 0; addr < 8; addr++)
+            values.push_back(a.m_memory->readMem(addr * 4));
+        return values;
+    };
+    for (int i = 0; i < n; i++) {
+        trace.push_back(sample());
+        a.clock();
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        a.reverse();
+        QVERIFY(sample() == trace[i]);
+    }
+    QVERIFY(!a.canReverse());
+}
+
+void tst_memory::reverseOverlappingWrites() {
+    // Through the journal, and through replaying from checkpoints
+    for (const size_t capacity : {size_t(1) << 20, size_t(0)}) {
+        vsrtl::DualWritePorts a;
+        a.setJournalCapacity(capacity);
+        a.verifyAndInitialize();
+
+        const int n = 20;
+        std::vector<vsrtl::VSRTL_VT_U> trace;
+        for (int i = 0; i < n; i++) {
+            trace.push_back(a.m_memory->readMem(0));
+            a.clock();
+        }
+        for (int i = n - 1; i >= 0; i--) {
+            a.reverse();
+            QCOMPARE(a.m_memory->readMem(0), trace[i]);
+        }
+        QCOMPARE(a.m_memory->readMem(0), 0u);
+    }
+}
+
+void tst_memory::pagedSparseArray() {
+    using namespace vsrtl::core;
+    SparseArray mem;
+    QVERIFY(mem.data.empty());
+    QCOMPARE(mem.readMem(0x1234), 0u);
+    QVERIFY(mem.data.empty());
+
+    // Aligned and unaligned accesses within a page, and accesses straddling a page boundary
+    mem.writeMem(0x100, 0xdeadbeef);
+    QCOMPARE(mem.readMem(0x100), 0xdeadbeefu);
+    QCOMPARE(mem.readMem(0x101, 2), 0xadbeu);
+    QCOMPARE(mem.readMem<false>(0x40), 0xdeadbeefu);
+    const unsigned boundary = MemoryPages::pageSize - 2;
+    mem.writeMem(boundary, 0x11223344);
+    QCOMPARE(mem.readMem(boundary), 0x11223344u);
+    QCOMPARE(mem.readMem(MemoryPages::pageSize, 2), 0x1122u);
+    QCOMPARE(mem.data.pageCount(), size_t(2));
+
+    // Sparse accesses at the extremes of the address space
+    mem.writeMem(0xfffffffc, 0xcafebabe);
+    mem.writeMem(0x80000000, 0x1, 1);
+    QCOMPARE(mem.readMem(0xfffffffc), 0xcafebabeu);
+    QCOMPARE(mem.readMem(0x80000000), 0x1u);
+    QVERIFY(mem.contains(0x80000fff));
+    QVERIFY(!mem.contains(0x80001000));
+    QCOMPARE(mem.data.pageCount(), size_t(4));
+
+    // Copies are deep
+    SparseArray copy = mem;
+    copy.writeMem(0x100, 0);
+    QCOMPARE(mem.readMem(0x100), 0xdeadbeefu);
+    QCOMPARE(copy.readMem(0xfffffffc), 0xcafebabeu);
+
+    // Resetting rewrites the initialization memories
+    const std::vector<uint32_t> program = {1, 2, 3};
+    mem.addInitializationMemory(0x2000, program.data(), program.size());
+    mem.reset();
+    QCOMPARE(mem.readMem(0x100), 0u);
+    QCOMPARE(mem.readMem(0x2008), 3u);
+    QCOMPARE(mem.data.pageCount(), size_t(1));
+
+    // Initialization images and copies share pages until written
+    const auto* image = mem.initializationImage.page(0x2000);
+    QCOMPARE(mem.data.page(0x2000), image);
+    SparseArray fork = mem;
+    QCOMPARE(fork.data.page(0x2000), image);
+    fork.writeMem(0x2004, 5);
+    QVERIFY(fork.data.page(0x2000) != image);
+    QCOMPARE(fork.readMem(0x2004), 5u);
+    QCOMPARE(mem.readMem(0x2004), 2u);
+    mem.writeMem(0x2004, 6);
+    QCOMPARE(mem.initializationImage.read(0x2004), uint8_t(2));
+    mem.reset();
+    QCOMPARE(mem.readMem(0x2004), 2u);
+    QCOMPARE(fork.readMem(0x2004), 5u);
+
+    // Overlapping initialization memories are merged; later memories overwrite earlier ones, including with zeros
+    const std::vector<uint8_t> patch = {0xaa};
+    mem.addInitializationMemory(0x2005, patch.data(), patch.size());
+    mem.reset();
+    QCOMPARE(mem.readMem(0x2004), 0xaa02u);
+    QCOMPARE(fork.readMem(0x2004), 5u);
+    const std::vector<uint8_t> zeros = {0, 0};
+    mem.addInitializationMemory(0x2004, zeros.data(), zeros.size());
+    mem.reset();
+    QCOMPARE(mem.readMem(0x2004), 0u);
+    QCOMPARE(mem.readMem(0x2008), 3u);
+}
+
+void tst_memory::programLoaders() {
+    using namespace vsrtl::core;
+    const auto dir = std::filesystem::temp_directory_path();
+    auto writeFile = [](const std::string& path, const std::vector<uint8_t>& bytes) {
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    };
+
+    // Flat binaries spanning multiple pages, at page aligned and unaligned addresses
+    std::vector<uint8_t> binary(3 * MemoryPages::pageSize + 10);
+    for (size_t i = 0; i < binary.size(); i++)
+        binary[i] = i * 7 + 1;
+    const auto binPath = (dir / "vsrtl_tst_memory.bin").string();
+    writeFile(binPath, binary);
+    SparseArray mem;
+    loadBinary(mem, binPath, 0x10000);
+    loadBinary(mem, binPath, 0x20003);
+    QCOMPARE(mem.readMem(0x10000), 0u);
+    mem.reset();
+    bool equal = true;
+    for (size_t i = 0; i < binary.size(); i++)
+        equal &= mem.readMem(0x10000 + i, 1) == binary[i] && mem.readMem(0x20003 + i, 1) == binary[i];
+    QVERIFY(equal);
+
+    // Writes neither modify the program nor the file
+    mem.writeMem(0x10000, 0);
+    mem.writeMem(0x11000, 0);
+    QCOMPARE(mem.readMem(0x11000), 0u);
+    mem.reset();
+    QCOMPARE(mem.readMem(0x10000, 1), VSRTL_VT_U(binary[0]));
+    QCOMPARE(mem.readMem(0x11000, 1), VSRTL_VT_U(binary[0x1000]));
+    mem.clearInitializationMemories();
+    mem.writeMem(0x11000, 0);
+    std::ifstream binFile(binPath, std::ios::binary);
+    QVERIFY(std::vector<uint8_t>(std::istreambuf_iterator<char>(binFile), {}) == binary);
+
+    // Intel HEX, with an extended linear address and a record straddling a page boundary
+    auto record = [](unsigned type, unsigned address, const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> bytes = {static_cast<uint8_t>(data.size()), static_cast<uint8_t>(address >> 8),
+                                      static_cast<uint8_t>(address), static_cast<uint8_t>(type)};
+        bytes.insert(bytes.end(), data.begin(), data.end());
+        uint8_t checksum = 0;
+        for (const auto& b : bytes)
+            checksum -= b;
+        bytes.push_back(checksum);
+        std::string line = ":";
+        const char* digits = "0123456789ABCDEF";
+        for (const auto& b : bytes)
+            line += std::string{digits[b >> 4], digits[b & 0xf]};
+        return line + "\r\n";
+    };
+    const std::string hex = record(0x04, 0, {0x00, 0x01}) + record(0x00, 0x0ffe, {0x11, 0x22, 0x33, 0x44}) +
+                            record(0x05, 0, {0x00, 0x01, 0x00, 0x00}) + record(0x01, 0, {});
+    const auto hexPath = (dir / "vsrtl_tst_memory.hex").string();
+    writeFile(hexPath, std::vector<uint8_t>(hex.begin(), hex.end()));
+    SparseArray hexMem;
+    loadIntelHex(hexMem, hexPath);
+    hexMem.reset();
+    QCOMPARE(hexMem.readMem(0x10ffe), 0x44332211u);
+    QCOMPARE(hexMem.data.pageCount(), size_t(2));
+    writeFile(hexPath, std::vector<uint8_t>(hex.begin(), hex.begin() + 30));
+    QVERIFY_EXCEPTION_THROWN(loadIntelHex(hexMem, hexPath), std::runtime_error);
+
+    // 32-bit ELF with a loadable segment at a physical address differing from its virtual address
+    std::vector<uint8_t> elf(0x2004);
+    auto put = [&](size_t offset, uint32_t value, unsigned size) {
+        for (unsigned i = 0; i < size; i++)
+            elf[offset + i] = value >> (i * 8);
+    };
+    elf[0] = 0x7f, elf[1] = 'E', elf[2] = 'L', elf[3] = 'F', elf[4] = 1, elf[5] = 1, elf[6] = 1;
+    put(24, 0x80000010, 4);  // e_entry
+    put(28, 52, 4);          // e_phoff
+    put(42, 32, 2);          // e_phentsize
+    put(44, 2, 2);           // e_phnum
+    put(52 + 0, 4, 4);       // PT_NOTE, ignored
+    put(52 + 4, 0, 4);
+    put(52 + 16, 0x100, 4);
+    put(84 + 0, 1, 4);  // PT_LOAD
+    put(84 + 4, 0x1000, 4);
+    put(84 + 8, 0x1000, 4);
+    put(84 + 12, 0x80000000, 4);
+    put(84 + 16, 0x1004, 4);
+    put(84 + 20, 0x2000, 4);
+    put(0x1000, 0xdeadbeef, 4);
+    put(0x2000, 0xcafebabe, 4);
+    const auto elfPath = (dir / "vsrtl_tst_memory.elf").string();
+    writeFile(elfPath, elf);
+    SparseArray elfMem;
+    QCOMPARE(loadElf(elfMem, elfPath), 0x80000010u);
+    elfMem.reset();
+    QCOMPARE(elfMem.readMem(0x80000000), 0xdeadbeefu);
+    QCOMPARE(elfMem.readMem(0x80001000), 0xcafebabeu);
+    QCOMPARE(elfMem.readMem(0x1000), 0u);
+    QCOMPARE(elfMem.readMem(0x80001004), 0u);
+    QVERIFY_EXCEPTION_THROWN(loadElf(elfMem, hexPath), std::runtime_error);
+
+    std::filesystem::remove(binPath);
+    std::filesystem::remove(hexPath);
+    std::filesystem::remove(elfPath);
+}
+
 QTEST_APPLESS_MAIN(tst_memory)
 #include "tst_memory.moc"
@@ -1,11 +1,23 @@
 #include <QtTest/QTest>
 
+#include "vsrtl_logicgate.h"
 #include "vsrtl_nestedexponenter.h"
 
 class tst_NestedComponents : public QObject {
     Q_OBJECT private slots : void functionalTest();
+    void largeComponentCounts();
 };
 
+namespace {
+using Gate = vsrtl::core::And<1, 2>;
+
+class ManyGates : public vsrtl::core::Design {
+public:
+    ManyGates() : Design("Many gates") {}
+    SUBCOMPONENTS(gates, Gate, 100000);
+};
+}  // namespace
+
 void tst_NestedComponents::functionalTest() {
     vsrtl::core::NestedExponenter a;
 
@@ -20,5 +32,19 @@ void tst_NestedComponents::functionalTest() {
     // We expect that m_cVal has been added to the register value n times
     // REQUIRE(a.regs->value(5) == 40);
 }
+
+void tst_NestedComponents::largeComponentCounts() {
+    // Names are looked up in sorted containers, such that elaboration does not scale quadratically in the number of
+    // subcomponents or ports of a component
+    ManyGates design;
+    QCOMPARE(design.getSubComponents().size(), size_t(100000));
+    QVERIFY_EXCEPTION_THROWN(design.create_component<Gate>("gates_99999"), std::runtime_error);
+
+    auto* gate = design.gates[0];
+    QCOMPARE(gate->createInputPorts<1>("extra", 100000).size(), size_t(100000));
+    QVERIFY_EXCEPTION_THROWN(gate->createOutputPort<1>("extra_123"), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(gate->createOutputPort<1>("in_0"), std::runtime_error);
+}
+
 QTEST_APPLESS_MAIN(tst_NestedComponents)
 #include "tst_nestedcomponent.moc"
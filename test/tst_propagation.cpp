@@ -0,0 +1,556 @@
+#include <QtTest/QTest>
+
+#include <sstream>
+#include <thread>
+
+#include "Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "vsrtl_adder.h"
+#include "vsrtl_collator.h"
+#include "vsrtl_constant.h"
+#include "vsrtl_decollator.h"
+#include "vsrtl_manynestedcomponents.h"
+#include "vsrtl_rannumgen.h"
+#include "vsrtl_xornetwork.h"
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_Propagation : public QObject {
+    Q_OBJECT
+
+private slots:
+    void eventDrivenRanNumGen();
+    void eventDrivenXorNetwork();
+    void eventDrivenLeros();
+    void passThroughAliasing();
+    void parallelXorNetwork();
+    void parallelLeros();
+    void batchLeros();
+    void bitPackedXorNetwork();
+    void bitPackedGateNetwork();
+    void constantFolding();
+    void headlessXorNetwork();
+    void batchedNotification();
+    void stateSnapshotLeros();
+    void forkLeros();
+    void designFootprint();
+    void deepPipeline();
+    void registerBank();
+};
+
+namespace {
+
+struct ChangeCounter {
+    void increment() { count++; }
+    unsigned count = 0;
+};
+
+/**
+ * A network of single-bit AND, XOR and OR gates of varying fan-in, driven by the bits of a counter register
+ */
+class GateNetwork : public Design {
+public:
+    static constexpr unsigned int gates = 24;
+
+    GateNetwork() : Design("Gate Network") {
+        0x9e3779b9 >> adder->op1;
+        counter->out >> adder->op2;
+        adder->out >> counter->in;
+        counter->out >> decol->in;
+
+        for (unsigned i = 0; i < gates; i++) {
+            for (unsigned k = 0; k < 3; k++)
+                *decol->out[(i + 7 * k) % 32] >> *ands[i]->in[k];
+            ands[i]->out >> *xors[i]->in[0];
+            *decol->out[(i * 5) % 32] >> *xors[i]->in[1];
+            xors[i]->out >> *ors[i]->in[0];
+            ands[(i + 1) % gates]->out >> *ors[i]->in[1];
+            ors[i]->out >> *col->in[i];
+        }
+        col->out >> result->in;
+    }
+
+    SUBCOMPONENTS(ands, TYPE(And<1, 3>), gates);
+    SUBCOMPONENTS(xors, TYPE(Xor<1, 2>), gates);
+    SUBCOMPONENTS(ors, TYPE(Or<1, 2>), gates);
+    SUBCOMPONENT(counter, Register<32>);
+    SUBCOMPONENT(adder, Adder<32>);
+    SUBCOMPONENT(decol, Decollator<32>);
+    SUBCOMPONENT(col, Collator<gates>);
+    SUBCOMPONENT(result, Register<gates>);
+};
+
+struct ChangeSetRecorder {
+    void record(const ChangeSet& changes) {
+        publications++;
+        ports = changes.ports;
+    }
+    unsigned publications = 0;
+    std::vector<PortBase*> ports;
+};
+
+void gatherPorts(SimComponent* c, std::vector<SimPort*>& ports) {
+    for (const auto& p : c->getAllPorts())
+        ports.push_back(p);
+    for (const auto& sc : c->getSubComponents())
+        gatherPorts(sc, ports);
+}
+
+/**
+ * Clocks and reverses two instances of the same design, verifying that the value of every port is equal in both
+ * designs after each operation.
+ */
+template <typename D>
+void compareDesigns(D& reference, D& dut, unsigned cycles) {
+    std::vector<SimPort*> refPorts, dutPorts;
+    gatherPorts(&reference, refPorts);
+    gatherPorts(&dut, dutPorts);
+    QCOMPARE(refPorts.size(), dutPorts.size());
+
+    auto verifyEqual = [&] {
+        for (unsigned i = 0; i < refPorts.size(); i++) {
+            QCOMPARE(refPorts[i]->uValue(), dutPorts[i]->uValue());
+        }
+    };
+
+    verifyEqual();
+    for (unsigned i = 0; i < cycles; i++) {
+        reference.clock();
+        dut.clock();
+        verifyEqual();
+    }
+    for (unsigned i = 0; i < cycles / 2; i++) {
+        reference.reverse();
+        dut.reverse();
+        verifyEqual();
+    }
+    reference.reset();
+    dut.reset();
+    verifyEqual();
+}
+
+/**
+ * The program of tst_leros::incInMemory, repeatedly incrementing a value in memory by @p increment
+ */
+std::vector<unsigned short> incInMemory(unsigned increment = 1) {
+    return {static_cast<unsigned short>(0x2900 + increment), 0x3000, 0x5000, 0x2100, 0x7000, 0x6000, 0x0901, 0x7000,
+            0x2100, 0x8FFC};
+}
+
+/**
+ * @returns an initialized SingleCycleLeros running incInMemory(@p increment), propagated in @p mode
+ */
+std::unique_ptr<leros::SingleCycleLeros> createLeros(PropagationMode mode = PropagationMode::full,
+                                                     unsigned increment = 1) {
+    auto design = std::make_unique<leros::SingleCycleLeros>();
+    design->setPropagationMode(mode);
+    const auto program = incInMemory(increment);
+    design->m_memory->addInitializationMemory(0x0, program.data(), program.size());
+    design->verifyAndInitialize();
+    return design;
+}
+
+/**
+ * A long chain of incrementers, closed by a register. Scheduling must not recurse along the chain.
+ */
+class IncrementerChain : public Design {
+public:
+    static constexpr unsigned length = 100000;
+
+    IncrementerChain() : Design("Incrementer chain") {
+        for (unsigned i = 0; i < adders.size(); i++) {
+            adders[i]->out >> (i + 1 == adders.size() ? reg->in : adders[i + 1]->op1);
+            1 >> adders[i]->op2;
+        }
+        reg->out >> adders[0]->op1;
+    }
+
+    SUBCOMPONENTS(adders, Adder<16>, length);
+    SUBCOMPONENT(reg, Register<16>);
+};
+
+/**
+ * An accumulator with synchronous clear and enable, controlled by the bits of a counter
+ */
+class ClearEnableAccumulator : public Design {
+public:
+    ClearEnableAccumulator() : Design("Clear/enable accumulator") {
+        counter->out >> inc->op1;
+        1 >> inc->op2;
+        inc->out >> counter->in;
+        counter->out >> bits->in;
+
+        acc->out >> add->op1;
+        5 >> add->op2;
+        add->out >> acc->in;
+        *bits->out[0] >> acc->enable;
+        *bits->out[1] >> acc->clear;
+    }
+
+    SUBCOMPONENT(counter, Register<3>);
+    SUBCOMPONENT(inc, Adder<3>);
+    SUBCOMPONENT(bits, Decollator<3>);
+    SUBCOMPONENT(acc, RegisterClEn<8>);
+    SUBCOMPONENT(add, Adder<8>);
+};
+
+}  // namespace
+
+void tst_Propagation::eventDrivenRanNumGen() {
+    RanNumGen reference, dut;
+    dut.setPropagationMode(PropagationMode::eventDriven);
+    reference.verifyAndInitialize();
+    dut.verifyAndInitialize();
+    compareDesigns(reference, dut, 100);
+}
+
+void tst_Propagation::eventDrivenXorNetwork() {
+    XorNetwork reference, dut;
+    dut.setPropagationMode(PropagationMode::eventDriven);
+    reference.verifyAndInitialize();
+    dut.verifyAndInitialize();
+    compareDesigns(reference, dut, 20);
+}
+
+void tst_Propagation::eventDrivenLeros() {
+    auto reference = createLeros();
+    auto dut = createLeros(PropagationMode::eventDriven);
+    compareDesigns(*reference, *dut, 200);
+}
+
+void tst_Propagation::parallelXorNetwork() {
+    XorNetwork reference, dut;
+    dut.setPropagationMode(PropagationMode::parallel);
+    dut.setParallelPropagation(4, 0, 8);
+    reference.verifyAndInitialize();
+    dut.verifyAndInitialize();
+    compareDesigns(reference, dut, 20);
+}
+
+void tst_Propagation::parallelLeros() {
+    auto reference = createLeros();
+    auto dut = createLeros(PropagationMode::parallel);
+    dut->setParallelPropagation(4, 0, 1);
+    compareDesigns(*reference, *dut, 200);
+}
+
+void tst_Propagation::batchLeros() {
+    // Each lane runs the increment program of tst_leros::incInMemory with a different increment
+    const unsigned nLanes = 3;
+    std::vector<std::unique_ptr<leros::SingleCycleLeros>> references;
+    for (unsigned lane = 0; lane < nLanes; lane++)
+        references.push_back(createLeros(PropagationMode::full, lane + 1));
+
+    leros::SingleCycleLeros batch;
+    batch.verifyAndInitialize();
+    batch.setLaneCount(nLanes);
+    QCOMPARE(batch.getLaneCount(), nLanes);
+    for (unsigned lane = 0; lane < nLanes; lane++) {
+        batch.setActiveLane(lane);
+        const auto program = incInMemory(lane + 1);
+        batch.m_memory->addInitializationMemory(0x0, program.data(), program.size());
+    }
+    batch.setActiveLane(1);
+    batch.reset();
+    QVERIFY(!batch.canReverse());
+
+    std::vector<SimPort*> batchPorts;
+    gatherPorts(&batch, batchPorts);
+    auto verifyLanes = [&] {
+        for (unsigned lane = 0; lane < nLanes; lane++) {
+            std::vector<SimPort*> refPorts;
+            gatherPorts(references[lane].get(), refPorts);
+            QCOMPARE(refPorts.size(), batchPorts.size());
+            for (unsigned i = 0; i < refPorts.size(); i++) {
+                QCOMPARE(batch.laneValue(lane, batchPorts[i]->cast<PortBase>()), refPorts[i]->uValue());
+            }
+        }
+    };
+
+    verifyLanes();
+    for (unsigned i = 0; i < 100; i++) {
+        batch.clock();
+        for (auto& reference : references)
+            reference->clock();
+        verifyLanes();
+    }
+    QCOMPARE(batch.getActiveLane(), 1u);
+
+    // Switching lanes exposes the lane's state through the design
+    batch.setActiveLane(2);
+    QCOMPARE(batch.m_memory->readMem(0x0), references[2]->m_memory->readMem(0x0));
+
+    batch.reset();
+    for (auto& reference : references)
+        reference->reset();
+    verifyLanes();
+}
+
+void tst_Propagation::bitPackedXorNetwork() {
+    XorNetwork reference, dut;
+    reference.setBitPackedEvaluation(false);
+    reference.verifyAndInitialize();
+    dut.verifyAndInitialize();
+    compareDesigns(reference, dut, 20);
+}
+
+void tst_Propagation::bitPackedGateNetwork() {
+    GateNetwork reference, dut;
+    reference.setBitPackedEvaluation(false);
+    reference.verifyAndInitialize();
+    dut.verifyAndInitialize();
+    compareDesigns(reference, dut, 100);
+}
+
+void tst_Propagation::constantFolding() {
+    // The operands of the adder are constants, and the adder is thus folded into a constant
+    class ConstantAdder : public Design {
+    public:
+        ConstantAdder() : Design("Constant adder") {
+            5 >> adder->op1;
+            7 >> adder->op2;
+            adder->out >> *sum->in[0];
+            reg->out >> *sum->in[1];
+            sum->out >> reg->in;
+        }
+        SUBCOMPONENT(adder, Adder<8>);
+        SUBCOMPONENT(sum, TYPE(Xor<8, 2>));
+        SUBCOMPONENT(reg, Register<8>);
+    };
+
+    ConstantAdder design;
+    design.verifyAndInitialize();
+
+    // The adder is evaluated once, whereas the XOR gate reading it is propagated each cycle
+    QCOMPARE(design.getFoldedComponents().size(), 1u);
+    QVERIFY(design.adder->out.isFolded());
+    QVERIFY(!design.sum->out.isFolded());
+    QCOMPARE(design.adder->out.uValue(), 12u);
+    QCOMPARE(design.sum->out.uValue(), 12u);
+    design.clock();
+    QCOMPARE(design.reg->out.uValue(), 12u);
+    design.clock();
+    QCOMPARE(design.reg->out.uValue(), 0u);
+    design.reset();
+    QCOMPARE(design.sum->out.uValue(), 12u);
+}
+
+void tst_Propagation::headlessXorNetwork() {
+    // No register reads the XOR grid; in headless mode, only the seed register and its adder are propagated
+    XorNetwork reference, dut;
+    dut.setHeadless(true);
+    reference.verifyAndInitialize();
+    dut.verifyAndInitialize();
+    const auto& schedule = dut.getPropagationSchedule();
+    QVERIFY(schedule.getOperations().size() < 10);
+    QVERIFY(dut.xors.back()->out.isPruned());
+    QVERIFY(!dut.adder->out.isPruned());
+
+    for (unsigned i = 0; i < 10; i++) {
+        reference.clock();
+        dut.clock();
+    }
+    QCOMPARE(dut.seedReg->out.uValue(), reference.seedReg->out.uValue());
+
+    // Reading a pruned port observes it, propagating its fan-in cone from then on
+    QCOMPARE(dut.xors.back()->out.uValue(), reference.xors.back()->out.uValue());
+    QVERIFY(!dut.xors.back()->out.isPruned());
+    QVERIFY(schedule.getOperations().size() > XorNetwork::rows);
+    compareDesigns(reference, dut, 20);
+}
+
+void tst_Propagation::batchedNotification() {
+    RanNumGen design;
+    design.verifyAndInitialize();
+    design.setChangeNotification(ChangeNotification::batched);
+
+    ChangeCounter portChanges;
+    ChangeSetRecorder recorder;
+    design.rngResReg->out.changed.Connect(&portChanges, &ChangeCounter::increment);
+    design.changesPublished.Connect(&recorder, &ChangeSetRecorder::record);
+
+    std::vector<SimPort*> ports;
+    gatherPorts(&design, ports);
+    for (unsigned i = 0; i < 10; i++) {
+        std::map<SimPort*, VSRTL_VT_U> before;
+        for (const auto& p : ports)
+            before[p] = p->uValue();
+
+        design.clock();
+        QCOMPARE(recorder.publications, i + 1);
+
+        // The change set contains exactly the ports which changed, each once
+        std::set<SimPort*> changed;
+        for (const auto& p : ports) {
+            if (p->uValue() != before[p])
+                changed.insert(p);
+        }
+        const std::set<SimPort*> published(recorder.ports.begin(), recorder.ports.end());
+        QCOMPARE(published.size(), recorder.ports.size());
+        QVERIFY(published == changed);
+        QVERIFY(published.count(&design.rngResReg->out) == 1);
+    }
+    QCOMPARE(portChanges.count, 0u);
+
+    design.setChangeNotification(ChangeNotification::perPort);
+    design.clock();
+    QCOMPARE(portChanges.count, 1u);
+    QCOMPARE(recorder.publications, 10u);
+}
+
+void tst_Propagation::stateSnapshotLeros() {
+    auto reference = createLeros();
+    auto dut = createLeros();
+    reference->runCycles(300);
+
+    std::stringstream state;
+    reference->saveState(state);
+    dut->restoreState(state);
+    QCOMPARE(dut->getCycleCount(), reference->getCycleCount());
+    QVERIFY(dut->m_memory->data == reference->m_memory->data);
+    QVERIFY(!dut->canReverse());
+    compareDesigns(*reference, *dut, 100);
+
+    // States are rejected by other designs
+    XorNetwork other;
+    other.verifyAndInitialize();
+    state.clear();
+    state.seekg(0);
+    QVERIFY_EXCEPTION_THROWN(other.restoreState(state), std::runtime_error);
+}
+
+void tst_Propagation::forkLeros() {
+    auto base = createLeros();
+    base->runCycles(100);
+
+    // Forks evolve identically to the design which they were forked from
+    auto reference = createLeros();
+    base->forkInto(*reference);
+    auto fork = createLeros();
+    base->forkInto(*fork);
+    compareDesigns(*reference, *fork, 100);
+
+    // Forks with diverging state may be simulated concurrently, without affecting the design they were forked from
+    const VSRTL_VT_U baseAcc = base->acc_reg->out.uValue();
+    std::vector<std::unique_ptr<leros::SingleCycleLeros>> forks;
+    for (unsigned i = 0; i < 4; i++) {
+        forks.push_back(createLeros());
+        base->forkInto(*forks.back());
+        forks.back()->setSynchronousValue(forks.back()->acc_reg, 0, 1000 * i);
+    }
+    std::vector<std::thread> threads;
+    for (auto& f : forks)
+        threads.emplace_back([&f] { f->runCycles(200); });
+    for (auto& t : threads)
+        t.join();
+
+    QCOMPARE(base->acc_reg->out.uValue(), baseAcc);
+    for (unsigned i = 0; i < forks.size(); i++) {
+        auto sequential = createLeros();
+        base->forkInto(*sequential);
+        sequential->setSynchronousValue(sequential->acc_reg, 0, 1000 * i);
+        sequential->runCycles(200);
+        QCOMPARE(forks[i]->getCycleCount(), 300ll);
+        QCOMPARE(forks[i]->acc_reg->out.uValue(), sequential->acc_reg->out.uValue());
+        QVERIFY(forks[i]->m_memory->data == sequential->m_memory->data);
+    }
+
+    // Forking a lane
+    auto expected = createLeros();
+    base->forkInto(*expected);
+    expected->clock();
+    auto expectedForced = createLeros();
+    base->forkInto(*expectedForced);
+    expectedForced->setSynchronousValue(expectedForced->acc_reg, 0, 1000);
+    expectedForced->clock();
+
+    const unsigned lane = base->forkLane();
+    QCOMPARE(base->getLaneCount(), 2u);
+    base->setActiveLane(lane);
+    base->setSynchronousValue(base->acc_reg, 0, 1000);
+    base->clock();
+    QCOMPARE(base->laneValue(0, &base->acc_reg->out), expected->acc_reg->out.uValue());
+    QCOMPARE(base->laneValue(lane, &base->acc_reg->out), expectedForced->acc_reg->out.uValue());
+}
+
+void tst_Propagation::designFootprint() {
+    leros::SingleCycleLeros design;
+    design.verifyAndInitialize();
+    const auto footprint = design.getDesignFootprint();
+    QVERIFY(footprint.ports > 0);
+    QVERIFY(footprint.components > 0);
+    QVERIFY(footprint.bytesPerPort() < 512);
+    QVERIFY(footprint.bytesPerComponent() < 2048);
+
+    // Change signals are only allocated once connected to
+    auto& port = design.acc_reg->out;
+    QVERIFY(!port.changed.isAllocated());
+    const size_t unconnected = port.getFootprint();
+    ChangeCounter counter;
+    port.changed.Connect(&counter, &ChangeCounter::increment);
+    QVERIFY(port.changed.isAllocated());
+    QVERIFY(port.getFootprint() > unconnected);
+
+    // Names of equally named ports share storage
+    XorNetwork a, b;
+    QCOMPARE(&a.getName(), &b.getName());
+}
+
+void tst_Propagation::deepPipeline() {
+    IncrementerChain design;
+    design.verifyAndInitialize();
+    QCOMPARE(design.adders.back()->out.uValue(), static_cast<VSRTL_VT_U>(IncrementerChain::length & 0xffff));
+    for (unsigned i = 1; i <= 3; i++) {
+        design.clock();
+        QCOMPARE(design.reg->out.uValue(), static_cast<VSRTL_VT_U>(i * IncrementerChain::length & 0xffff));
+    }
+}
+
+void tst_Propagation::registerBank() {
+    ClearEnableAccumulator design;
+    design.verifyAndInitialize();
+
+    std::vector<VSRTL_VT_U> history = {0};
+    VSRTL_VT_U counter = 0, acc = 0;
+    for (unsigned i = 0; i < 40; i++) {
+        if (counter & 0b1)
+            acc = counter & 0b10 ? 0 : (acc + 5) & 0xff;
+        counter = (counter + 1) & 0b111;
+        design.clock();
+        QCOMPARE(design.counter->out.uValue(), counter);
+        QCOMPARE(design.acc->out.uValue(), acc);
+        history.push_back(acc);
+    }
+
+    // Banked register state is journaled
+    for (unsigned i = 0; i < 20; i++) {
+        design.reverse();
+        history.pop_back();
+        QCOMPARE(design.acc->out.uValue(), history.back());
+    }
+
+    design.setSynchronousValue(design.acc, 0, 0x1ff);
+    QCOMPARE(design.acc->out.uValue(), 0xffu);
+    design.reset();
+    QCOMPARE(design.acc->out.uValue(), 0u);
+}
+
+void tst_Propagation::passThroughAliasing() {
+    NestedExponenter design;
+    design.verifyAndInitialize();
+
+    // exp->out is a hierarchy boundary port forwarding the output of the exponenter register
+    ChangeCounter regOutChanges, expOutChanges;
+    design.exp->expReg->out.changed.Connect(&regOutChanges, &ChangeCounter::increment);
+    design.exp->out.changed.Connect(&expOutChanges, &ChangeCounter::increment);
+
+    for (int i = 0; i < 10; i++) {
+        design.clock();
+        QCOMPARE(design.exp->out.uValue(), design.exp->expReg->out.uValue());
+    }
+    QVERIFY(regOutChanges.count > 0);
+    QCOMPARE(expOutChanges.count, regOutChanges.count);
+}
+
+QTEST_APPLESS_MAIN(tst_Propagation)
+#include "tst_propagation.moc"
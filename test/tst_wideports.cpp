@@ -0,0 +1,144 @@
+#include <QtTest/QTest>
+
+#include "vsrtl_adder.h"
+#include "vsrtl_collator.h"
+#include "vsrtl_constant.h"
+#include "vsrtl_decollator.h"
+#include "vsrtl_design.h"
+#include "vsrtl_logicgate.h"
+#include "vsrtl_multiplexer.h"
+#include "vsrtl_register.h"
+#include "vsrtl_shift.h"
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_WidePorts : public QObject {
+    Q_OBJECT
+private slots:
+    void wideValueArithmetic();
+    void wideValueShifts();
+    void wideCounter();
+};
+
+namespace {
+
+/**
+ * A 100-bit counter, with its value shifted, inverted and split into bits
+ */
+class WideCounter : public Design {
+public:
+    static constexpr unsigned int width = 100;
+
+    WideCounter() : Design("Wide counter") {
+        1 >> adder->op1;
+        reg->out >> adder->op2;
+        adder->out >> reg->in;
+
+        reg->out >> shl->in;
+        reg->out >> *inv->in[0];
+        0 >> *inv->in[1];
+        shl->out >> *mux->ins[0];
+        reg->out >> *mux->ins[1];
+        1 >> mux->select;
+
+        reg->out >> decol->in;
+        for (unsigned i = 0; i < width; i++)
+            *decol->out[i] >> *col->in[i];
+    }
+
+    SUBCOMPONENT(reg, Register<width>);
+    SUBCOMPONENT(adder, Adder<width>);
+    SUBCOMPONENT(shl, Shift<width>, ShiftType::sl, 40);
+    SUBCOMPONENT(inv, TYPE(Xor<width, 2>));
+    SUBCOMPONENT(mux, TYPE(Multiplexer<2, width>));
+    SUBCOMPONENT(decol, Decollator<width>);
+    SUBCOMPONENT(col, Collator<width>);
+};
+
+}  // namespace
+
+void tst_WidePorts::wideValueArithmetic() {
+    using V = WideValue<100>;
+    QCOMPARE(V::limbs, 4u);
+
+    // Carry propagates across limbs
+    const V sum = V(0xffffffff) + V(1);
+    QCOMPARE(sum.limb(0), 0u);
+    QCOMPARE(sum.limb(1), 1u);
+
+    // Values wrap around modulo 2^100
+    const V max = ~V(0);
+    QCOMPARE(max.limb(3), 0xfu);
+    QVERIFY(max + V(1) == V(0));
+    QVERIFY(V(0) - V(1) == max);
+    QVERIFY(sum - V(1) == V(0xffffffff));
+
+    QVERIFY((max & V(0x1234)) == V(0x1234));
+    QVERIFY((V(0xf0) | V(0x0f)) == V(0xff));
+    QVERIFY((max ^ max) == V(0));
+}
+
+void tst_WidePorts::wideValueShifts() {
+    using V = WideValue<100>;
+    const V one(1);
+
+    QVERIFY((one << 99).bit(99));
+    QVERIFY((one << 99).msb());
+    QVERIFY((one << 100) == V(0));
+    QVERIFY(((one << 99) >> 99) == one);
+
+    const V v = V(0xdeadbeef) << 36;
+    QCOMPARE(v.limb(1), 0xdeadbeefu << 4);
+    QCOMPARE(v.limb(2), 0xdeadbeefu >> 28);
+    QVERIFY((v >> 36) == V(0xdeadbeef));
+
+    // Arithmetic right shift replicates the sign bit of the 100-bit value
+    const V negative = one << 99;
+    const V shifted = negative.sra(98);
+    QVERIFY(shifted.bit(99) && shifted.bit(98) && shifted.bit(1) && !shifted.bit(0));
+}
+
+void tst_WidePorts::wideCounter() {
+    WideCounter design;
+    design.verifyAndInitialize();
+
+    QVERIFY(design.reg->out.wideValue() == WideValue<100>(0));
+    design.clock();
+    QCOMPARE(design.reg->out.uValue(), 1u);
+
+    // Overflowing the least significant limb carries into the next limb
+    design.setSynchronousValue(design.reg, 0, 0xffffffff);
+    design.clock();
+    const auto value = design.reg->out.wideValue();
+    QCOMPARE(value.limb(0), 0u);
+    QCOMPARE(value.limb(1), 1u);
+
+    QVERIFY(design.shl->out.wideValue() == (value << 40));
+    QVERIFY(design.shl->out.wideValue().bit(72));
+    QVERIFY(design.mux->out.wideValue() == value);
+    QVERIFY(design.inv->out.wideValue() == value);
+    QVERIFY(design.col->out.wideValue() == value);
+    QCOMPARE(design.decol->out[32]->uValue(), 1u);
+    QCOMPARE(design.decol->out[0]->uValue(), 0u);
+
+    // Reversing restores the value which was forced prior to clocking
+    design.reverse();
+    QVERIFY(design.reg->out.wideValue() == WideValue<100>(0xffffffff));
+    QCOMPARE(design.decol->out[32]->uValue(), 0u);
+    QCOMPARE(design.decol->out[31]->uValue(), 1u);
+
+    // Event-driven propagation yields identical results
+    WideCounter eventDriven;
+    eventDriven.setPropagationMode(PropagationMode::eventDriven);
+    eventDriven.verifyAndInitialize();
+    design.reset();
+    for (unsigned i = 0; i < 10; i++) {
+        design.clock();
+        eventDriven.clock();
+        QVERIFY(design.col->out.wideValue() == eventDriven.col->out.wideValue());
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_WidePorts)
+#include "tst_wideports.moc"